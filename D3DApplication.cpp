@@ -1,5 +1,8 @@
 #include "D3DApplication.h"
+#include "FileDialog.h"
 #include "InjectorUI.h"
+#include "StartupTrace.h"
+#include "TextConversion.h"
 #include "TitleBarUI.h"
 
 #include <imgui.h>
@@ -8,8 +11,13 @@
 #include <backends/imgui_impl_dx11.h>
 #include <cstdio>    // Required for sprintf_s
 #include <debugapi.h> // Required for OutputDebugStringW
+#include <dxgi1_5.h>  // Required for IDXGISwapChain2 and DXGI_FEATURE_PRESENT_ALLOW_TEARING
+
+extern IMGUI_IMPL_API LRESULT
+	ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
 #pragma comment(lib, "d3d11.lib")
+#pragma comment(lib, "dxgi.lib")
 
 D3DApplication* D3DApplication::Instance = nullptr;
 
@@ -59,6 +67,7 @@ bool D3DApplication::Initialize(int PositionX, int PositionY, int Width, int Hei
 		return false;
 	} else {
 		OutputDebugStringW(L"RegisterClassExW SUCCEEDED.\n");
+		StartupTrace::Global().Mark("Window class registered");
 	}
 
 	swprintf_s(debugMsg, L"Attempting to create window with class: %s and HINSTANCE: %p\n", uniqueClassName, (void*)ApplicationInstance);
@@ -90,6 +99,13 @@ bool D3DApplication::Initialize(int PositionX, int PositionY, int Width, int Hei
 		// Now WindowHandle (member) is valid.
 		swprintf_s(debugMsg, L"CreateWindowExW SUCCEEDED. Member HWND this->WindowHandle: %p\n", (void*)this->WindowHandle);
 		OutputDebugStringW(debugMsg);
+		StartupTrace::Global().Mark("Window created");
+	}
+
+	QueryPerformanceFrequency(&TimerFrequency);
+	RedrawEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr); // Auto-reset, signalled by RequestRedraw()
+	if (!RedrawEvent) {
+		OutputDebugStringW(L"CreateEventW for RedrawEvent failed, falling back to continuous rendering.\n");
 	}
 
 	SetWindowPos(this->WindowHandle, nullptr, 0, 0, 0, 0, SWP_FRAMECHANGED | SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER);
@@ -101,54 +117,273 @@ bool D3DApplication::Initialize(int PositionX, int PositionY, int Width, int Hei
 		return false;
 	}
 	OutputDebugStringW(L"CreateDeviceAndSwapChain succeeded.\n");
-
-	ShowWindow(this->WindowHandle, SW_SHOWDEFAULT); // Uses this->WindowHandle
-	UpdateWindow(this->WindowHandle);             // Uses this->WindowHandle
+	StartupTrace::Global().Mark("Device and swap chain created");
 
 	IMGUI_CHECKVERSION();
 	ImGui::CreateContext();
 	ImGui::StyleColorsDark();
 	ImGui_ImplWin32_Init(this->WindowHandle); // Uses this->WindowHandle, which is valid
 	ImGui_ImplDX11_Init(Device, DeviceContext);
-	InjectorPanel = new InjectorUI(this->WindowHandle); // Passes valid HWND
-	TitleBar = new TitleBarUI(this->WindowHandle);     // Passes valid HWND
+	Profiler.Initialize(Device, DeviceContext);
+	StartupTrace::Global().Mark("ImGui initialized");
+	// Panels only set up their workers here; enumeration starts after the first frame is presented
+	InjectorPanel = new InjectorUI(*this, CreatePlatformProcessSource(), CreatePlatformProcessSource(), CreatePlatformProcessSource(),
+		CreatePlatformInjectionBackend());
+	TitleBar = new TitleBarUI(*this); // Window services go through the UIHost overrides below
 	OutputDebugStringW(L"ImGui initialized and UI panels created.\n");
+	StartupTrace::Global().Mark("UI panels created");
+
+	// Shown last, so the first frame follows immediately instead of an unpainted window
+	ShowWindow(this->WindowHandle, SW_SHOWDEFAULT); // Uses this->WindowHandle
+	UpdateWindow(this->WindowHandle);             // Uses this->WindowHandle
+	StartupTrace::Global().Mark("Window shown");
 	return true;
 }
 
 void D3DApplication::RunMessageLoop() {
 	OutputDebugStringW(L"RunMessageLoop starting.\n");
+	LARGE_INTEGER WindowStart;
+	QueryPerformanceCounter(&WindowStart);
+	long long WindowIdleTicks = 0;
+	PendingFrames = SettleFrameCount;
+
 	MSG Message = {};
-	while (Message.message != WM_QUIT) {
-		if (PeekMessageW(&Message, nullptr, 0, 0, PM_REMOVE)) {
+	bool Running = true;
+	while (Running) {
+		// Drain everything queued before deciding whether a frame is needed
+		while (PeekMessageW(&Message, nullptr, 0, 0, PM_REMOVE)) {
+			if (Message.message == WM_QUIT) {
+				Running = false;
+				break;
+			}
 			TranslateMessage(&Message);
 			DispatchMessageW(&Message);
+			PendingFrames = SettleFrameCount;
+		}
+		if (!Running) {
+			break;
+		}
+
+		if (!EventDrivenRendering || !RedrawEvent || PendingFrames > 0) {
+			RenderFrame();
+			if (PendingFrames > 0) {
+				--PendingFrames;
+			}
 		} else {
-			ImGui_ImplDX11_NewFrame();
-			ImGui_ImplWin32_NewFrame();
-			ImGui::NewFrame();
-
-			if (TitleBar) TitleBar->Render();
-			if (InjectorPanel) InjectorPanel->Render();
-
-			ImGui::Render();
-			const float ClearColor[4] = { 0.1f, 0.105f, 0.11f, 1.0f };
-			DeviceContext->OMSetRenderTargets(1, &RenderTargetView, nullptr);
-			DeviceContext->ClearRenderTargetView(RenderTargetView, ClearColor);
-			ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
-			SwapChain->Present(1, 0);
+			// Nothing changed: sleep until input, a redraw request or the animation tick
+			const DWORD Timeout = WantsAnimation() ? AnimationIntervalMilliseconds : INFINITE;
+			LARGE_INTEGER WaitStart, WaitEnd;
+			QueryPerformanceCounter(&WaitStart);
+			DWORD WaitResult = MsgWaitForMultipleObjectsEx(1, &RedrawEvent, Timeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+			QueryPerformanceCounter(&WaitEnd);
+			WindowIdleTicks += WaitEnd.QuadPart - WaitStart.QuadPart;
+			Statistics.Wakeups++;
+
+			if (WaitResult == WAIT_OBJECT_0) {
+				PendingFrames = SettleFrameCount; // Background result arrived
+			} else if (WaitResult == WAIT_TIMEOUT) {
+				PendingFrames = 1; // Animation tick
+			} else if (WaitResult == WAIT_FAILED) {
+				EventDrivenRendering = false; // Never spin on a broken wait; fall back to continuous rendering
+			}
+			// WAIT_OBJECT_0 + 1: input is pending and gets drained at the top of the loop
+		}
+
+		LARGE_INTEGER Now;
+		QueryPerformanceCounter(&Now);
+		const long long WindowTicks = Now.QuadPart - WindowStart.QuadPart;
+		if (WindowTicks >= TimerFrequency.QuadPart) {
+			Statistics.IdleRatio = static_cast<double>(WindowIdleTicks) / static_cast<double>(WindowTicks);
+			WindowStart = Now;
+			WindowIdleTicks = 0;
+		}
+	}
+
+	WCHAR debugMsg[256];
+	swprintf_s(debugMsg, L"RunMessageLoop finished. Frames: %llu, wakeups: %llu, avg frame: %.3f ms, idle ratio: %.2f\n",
+		Statistics.FramesRendered, Statistics.Wakeups, Statistics.AverageFrameMilliseconds, Statistics.IdleRatio);
+	OutputDebugStringW(debugMsg);
+	OutputDebugStringA(("Startup trace:\n" + StartupTrace::Global().Format()).c_str());
+}
+
+void D3DApplication::RenderFrame() {
+	ApplyPendingResize();
+	if (!RenderTargetView) {
+		return; // Resize failed; try again on the next frame
+	}
+
+	// Flip model: block until the swap chain can take a frame, so input is sampled as late as possible
+	if (FrameLatencyWaitableObject) {
+		WaitForSingleObjectEx(FrameLatencyWaitableObject, 1000, TRUE);
+	}
+
+	LARGE_INTEGER FrameStart, FrameEnd;
+	QueryPerformanceCounter(&FrameStart);
+
+	Profiler.BeginPhase(ProfilePhase::NewFrame);
+	ImGui_ImplDX11_NewFrame();
+	ImGui_ImplWin32_NewFrame();
+	ImGui::NewFrame();
+	Profiler.EndPhase(ProfilePhase::NewFrame);
+	if (Statistics.FramesRendered == 0) {
+		StartupTrace::Global().Mark("First NewFrame (font atlas uploaded)");
+	}
+
+	Profiler.BeginPhase(ProfilePhase::TitleBar);
+	if (TitleBar) TitleBar->Render();
+	Profiler.EndPhase(ProfilePhase::TitleBar);
+	Profiler.BeginPhase(ProfilePhase::InjectorPanel);
+	if (InjectorPanel) InjectorPanel->Render();
+	Profiler.EndPhase(ProfilePhase::InjectorPanel);
+	Profiler.RenderOverlay(Statistics);
+
+	Profiler.BeginPhase(ProfilePhase::ImGuiRender);
+	ImGui::Render();
+	Profiler.EndPhase(ProfilePhase::ImGuiRender);
+
+	Profiler.BeginGpu();
+	const float ClearColor[4] = { 0.1f, 0.105f, 0.11f, 1.0f };
+	DeviceContext->OMSetRenderTargets(1, &RenderTargetView, nullptr);
+	DeviceContext->ClearRenderTargetView(RenderTargetView, ClearColor);
+	Profiler.BeginPhase(ProfilePhase::RenderDrawData);
+	ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+	Profiler.EndPhase(ProfilePhase::RenderDrawData);
+	Profiler.EndGpu();
+	if (TearingSupported) {
+		SwapChain->Present(0, DXGI_PRESENT_ALLOW_TEARING); // Paced by the waitable object; VRR displays follow the app
+	} else {
+		SwapChain->Present(1, 0);
+	}
+	Profiler.EndFrame(ImGui::GetDrawData());
+	if (Statistics.FramesRendered == 0) {
+		StartupTrace::Global().Mark("First frame presented");
+		if (InjectorPanel) InjectorPanel->StartBackgroundWork(); // Process list fills in once the worker publishes
+	}
+
+	QueryPerformanceCounter(&FrameEnd);
+	const double FrameMilliseconds = static_cast<double>(FrameEnd.QuadPart - FrameStart.QuadPart) * 1000.0 / static_cast<double>(TimerFrequency.QuadPart);
+	Statistics.LastFrameMilliseconds = FrameMilliseconds;
+	Statistics.AverageFrameMilliseconds = Statistics.FramesRendered == 0
+		? FrameMilliseconds
+		: Statistics.AverageFrameMilliseconds * 0.95 + FrameMilliseconds * 0.05;
+	Statistics.FramesRendered++;
+}
+
+void D3DApplication::ApplyPendingResize() {
+	if (!ResizePending || !Device || PendingWidth == 0 || PendingHeight == 0) {
+		return;
+	}
+	ResizePending = false;
+
+	DeviceContext->OMSetRenderTargets(0, nullptr, nullptr); // Flip model refuses to resize while a back buffer is bound
+	if (RenderTargetView) {
+		RenderTargetView->Release();
+		RenderTargetView = nullptr;
+	}
+	HRESULT hr = SwapChain->ResizeBuffers(0, PendingWidth, PendingHeight, DXGI_FORMAT_UNKNOWN, SwapChainFlags);
+	if (SUCCEEDED(hr)) {
+		ID3D11Texture2D* BackBuffer = nullptr;
+		hr = SwapChain->GetBuffer(0, IID_PPV_ARGS(&BackBuffer));
+		if (SUCCEEDED(hr) && BackBuffer) {
+			Device->CreateRenderTargetView(BackBuffer, nullptr, &RenderTargetView);
+			BackBuffer->Release();
 		}
 	}
-	OutputDebugStringW(L"RunMessageLoop finished.\n");
+	if (!RenderTargetView) {
+		ResizePending = true; // Retry with the same size next frame
+		char debugMsgA[128];
+		sprintf_s(debugMsgA, sizeof(debugMsgA), "Swap chain resize failed with HRESULT: 0x%08X\n", static_cast<unsigned int>(hr));
+		OutputDebugStringA(debugMsgA);
+		return;
+	}
+	Statistics.SwapChainResizes++;
+}
+
+bool D3DApplication::WantsAnimation() const {
+	// The text caret blinks and held widgets may change without new input; the profiler shows live numbers
+	const ImGuiIO& IO = ImGui::GetIO();
+	return IO.WantTextInput || Profiler.IsVisible() || ImGui::IsAnyItemActive() || (InjectorPanel && InjectorPanel->IsAnimating());
+}
+
+void D3DApplication::RequestRedraw() {
+	if (RedrawEvent) {
+		SetEvent(RedrawEvent);
+	}
+}
+
+void D3DApplication::RequestMinimize() {
+	ShowWindow(WindowHandle, SW_MINIMIZE);
+}
+
+void D3DApplication::RequestClose() {
+	PostMessage(WindowHandle, WM_CLOSE, 0, 0);
+}
+
+void D3DApplication::ScreenToClientPoint(float& X, float& Y) const {
+	POINT Point = { static_cast<LONG>(X), static_cast<LONG>(Y) };
+	ScreenToClient(WindowHandle, &Point);
+	X = static_cast<float>(Point.x);
+	Y = static_cast<float>(Point.y);
+}
+
+bool D3DApplication::BrowseForDLL(std::function<void(std::string)> OnChosen) {
+	if (FileDialogOpen.exchange(true)) {
+		return false;
+	}
+	if (FileDialogThread.joinable()) {
+		FileDialogThread.join(); // The previous picker has already returned
+	}
+	FileDialogThread = std::thread([this, OnChosen = std::move(OnChosen)] {
+		std::wstring Path;
+		const bool Chosen = FileDialog::SelectDLL(WindowHandle, Path);
+		OnChosen(Chosen ? Utf8FromWide(Path) : std::string());
+		FileDialogOpen = false;
+	});
+	return true;
+}
+
+std::filesystem::path D3DApplication::DataDirectory() const {
+	WCHAR ExecutablePath[MAX_PATH];
+	const DWORD Length = GetModuleFileNameW(nullptr, ExecutablePath, MAX_PATH);
+	if (Length == 0 || Length >= MAX_PATH) {
+		return std::filesystem::current_path();
+	}
+	return std::filesystem::path(ExecutablePath).parent_path();
 }
 
 void D3DApplication::Shutdown() {
 	OutputDebugStringW(L"Shutdown initiated.\n");
+	if (FileDialogThread.joinable()) {
+		// Close a picker that is still open, then wait so its result never reaches a deleted panel. The dialog
+		// is owned by our window and re-enables it with a message sent to this thread when it closes, so keep
+		// pumping while waiting. The close is repeated because the dialog window may not exist yet.
+		const HANDLE DialogThread = FileDialogThread.native_handle();
+		const DWORD DialogThreadId = GetThreadId(DialogThread);
+		for (;;) {
+			EnumThreadWindows(DialogThreadId, [](HWND DialogWindow, LPARAM) -> BOOL {
+				PostMessageW(DialogWindow, WM_CLOSE, 0, 0);
+				return TRUE;
+			}, 0);
+			const DWORD WaitResult = MsgWaitForMultipleObjects(1, &DialogThread, FALSE, 100, QS_ALLINPUT);
+			if (WaitResult == WAIT_OBJECT_0 || WaitResult == WAIT_FAILED) {
+				break;
+			}
+			MSG Message;
+			while (PeekMessageW(&Message, nullptr, 0, 0, PM_REMOVE)) {
+				if (Message.message != WM_QUIT) { // Already shutting down
+					TranslateMessage(&Message);
+					DispatchMessageW(&Message);
+				}
+			}
+		}
+		FileDialogThread.join();
+	}
 	delete InjectorPanel;
 	InjectorPanel = nullptr;
 	delete TitleBar;
 	TitleBar = nullptr;
 
+	Profiler.Shutdown();
 	ImGui_ImplDX11_Shutdown();
 	ImGui_ImplWin32_Shutdown();
 	ImGui::DestroyContext();
@@ -157,6 +392,11 @@ void D3DApplication::Shutdown() {
 	DestroyDeviceAndSwapChain(); // Uses member variables
 	OutputDebugStringW(L"Device and SwapChain destroyed.\n");
 
+	if (RedrawEvent) {
+		CloseHandle(RedrawEvent);
+		RedrawEvent = nullptr;
+	}
+
 	if (this->WindowHandle) { // Check member variable
 		DestroyWindow(this->WindowHandle);
 		WCHAR debugMsg[128];
@@ -179,9 +419,36 @@ void D3DApplication::Shutdown() {
 	ApplicationInstance = nullptr;
 }
 
-bool D3DApplication::CreateDeviceAndSwapChain() {
+// Tearing lets a windowed flip-model swap chain present immediately (and drive VRR displays)
+static bool IsTearingSupported() {
+	IDXGIFactory1* Factory = nullptr;
+	if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&Factory)))) {
+		return false;
+	}
+	BOOL AllowTearing = FALSE;
+	IDXGIFactory5* Factory5 = nullptr;
+	if (SUCCEEDED(Factory->QueryInterface(IID_PPV_ARGS(&Factory5)))) {
+		if (FAILED(Factory5->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING, &AllowTearing, sizeof(AllowTearing)))) {
+			AllowTearing = FALSE;
+		}
+		Factory5->Release();
+	}
+	Factory->Release();
+	return AllowTearing == TRUE;
+}
+
+bool D3DApplication::TryCreateDeviceAndSwapChain(bool FlipModel, HRESULT& Result) {
     // This function uses this->WindowHandle, which is assumed to be valid
     // if Initialize() has progressed past CreateWindowExW successfully.
+	TearingSupported = FlipModel && IsTearingSupported();
+	SwapChainFlags = 0;
+	if (FlipModel) {
+		SwapChainFlags |= DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+		if (TearingSupported) {
+			SwapChainFlags |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+		}
+	}
+
 	DXGI_SWAP_CHAIN_DESC SwapChainDescription = {};
 	SwapChainDescription.BufferCount = 2;
 	SwapChainDescription.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
@@ -189,7 +456,8 @@ bool D3DApplication::CreateDeviceAndSwapChain() {
 	SwapChainDescription.OutputWindow = this->WindowHandle; // Correct use of member after it's set
 	SwapChainDescription.SampleDesc.Count = 1;
 	SwapChainDescription.Windowed = TRUE;
-	SwapChainDescription.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+	SwapChainDescription.SwapEffect = FlipModel ? DXGI_SWAP_EFFECT_FLIP_DISCARD : DXGI_SWAP_EFFECT_DISCARD;
+	SwapChainDescription.Flags = SwapChainFlags;
 
 	UINT CreationFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
 #ifdef _DEBUG
@@ -197,8 +465,36 @@ bool D3DApplication::CreateDeviceAndSwapChain() {
 #endif
 
 	D3D_FEATURE_LEVEL FeatureLevel;
-	HRESULT hr = D3D11CreateDeviceAndSwapChain(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, CreationFlags, nullptr, 0, D3D11_SDK_VERSION, &SwapChainDescription, &SwapChain, &Device, &FeatureLevel, &DeviceContext);
-	if (FAILED(hr)) {
+	Result = D3D11CreateDeviceAndSwapChain(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, CreationFlags, nullptr, 0, D3D11_SDK_VERSION, &SwapChainDescription, &SwapChain, &Device, &FeatureLevel, &DeviceContext);
+	if (FAILED(Result)) {
+		return false;
+	}
+	if (!FlipModel) {
+		return true;
+	}
+
+	// Queue at most one frame and hand the loop an object to wait on before building the next one
+	IDXGISwapChain2* SwapChain2 = nullptr;
+	Result = SwapChain->QueryInterface(IID_PPV_ARGS(&SwapChain2));
+	if (FAILED(Result)) {
+		DestroyDeviceAndSwapChain();
+		return false;
+	}
+	SwapChain2->SetMaximumFrameLatency(1);
+	FrameLatencyWaitableObject = SwapChain2->GetFrameLatencyWaitableObject();
+	SwapChain2->Release();
+	return true;
+}
+
+bool D3DApplication::CreateDeviceAndSwapChain() {
+	HRESULT hr = S_OK;
+	if (UseFlipModel && !TryCreateDeviceAndSwapChain(true, hr)) {
+		char debugMsgA[128];
+		sprintf_s(debugMsgA, sizeof(debugMsgA), "Flip-model swap chain unavailable (HRESULT: 0x%08X), using the blt model.\n", static_cast<unsigned int>(hr));
+		OutputDebugStringA(debugMsgA);
+		UseFlipModel = false;
+	}
+	if (!UseFlipModel && !TryCreateDeviceAndSwapChain(false, hr)) {
 		char errorMsg[256];
 		sprintf_s(errorMsg, sizeof(errorMsg), "D3D11CreateDeviceAndSwapChain failed with HRESULT: 0x%08X", static_cast<unsigned int>(hr));
 		MessageBoxA(nullptr, errorMsg, "D3D Initialization Error", MB_OK | MB_ICONERROR);
@@ -230,6 +526,10 @@ bool D3DApplication::CreateDeviceAndSwapChain() {
 }
 
 void D3DApplication::DestroyDeviceAndSwapChain() {
+	if (FrameLatencyWaitableObject) {
+		CloseHandle(FrameLatencyWaitableObject);
+		FrameLatencyWaitableObject = nullptr;
+	}
 	if (RenderTargetView) {
 		RenderTargetView->Release();
 		RenderTargetView = nullptr;
@@ -269,28 +569,34 @@ LRESULT D3DApplication::HandleWindowMessage(HWND hwnd, UINT Message, WPARAM WPar
 			OutputDebugStringW(debugMsg);
 			break;
 		case WM_SIZE: {
-            // For WM_SIZE, this->WindowHandle should be valid if it's not SIZE_MINIMIZED during init.
-            // However, using 'hwnd' is safer and consistent.
-			if (Device && WParam != SIZE_MINIMIZED) {
-				if (RenderTargetView) {
-					RenderTargetView->Release();
-					RenderTargetView = nullptr;
-				}
-				// Ensure hwnd is used if operations here are critical before this->WindowHandle is set, though less likely for WM_SIZE.
-				HRESULT hr = SwapChain->ResizeBuffers(0, static_cast<UINT>(LOWORD(LParam)), static_cast<UINT>(HIWORD(LParam)), DXGI_FORMAT_UNKNOWN, 0);
-				if (SUCCEEDED(hr)) {
-					ID3D11Texture2D* BackBuffer = nullptr;
-					hr = SwapChain->GetBuffer(0, IID_PPV_ARGS(&BackBuffer));
-					if (SUCCEEDED(hr)) {
-						if (BackBuffer) { 
-							Device->CreateRenderTargetView(BackBuffer, nullptr, &RenderTargetView);
-							BackBuffer->Release();
-						}
-					}
-				}
+			// Coalesce: a drag produces a stream of these, only the last size matters
+			if (WParam != SIZE_MINIMIZED) {
+				PendingWidth = static_cast<UINT>(LOWORD(LParam));
+				PendingHeight = static_cast<UINT>(HIWORD(LParam));
+				ResizePending = true;
 			}
 			return 0;
 		}
+		case WM_ENTERSIZEMOVE: {
+			// DefWindowProc runs its own modal loop until WM_EXITSIZEMOVE; keep drawing from a timer
+			InSizeMove = true;
+			SetTimer(hwnd, SizeMoveTimerID, SizeMoveFrameMilliseconds, nullptr);
+			break;
+		}
+		case WM_EXITSIZEMOVE: {
+			InSizeMove = false;
+			KillTimer(hwnd, SizeMoveTimerID);
+			break;
+		}
+		case WM_TIMER: {
+			if (WParam == SizeMoveTimerID) {
+				if (Device && InSizeMove) {
+					RenderFrame();
+				}
+				return 0;
+			}
+			break;
+		}
 		case WM_SYSCOMMAND: {
 			if ((WParam & 0xFFF0) == SC_KEYMENU) {
 				return 0;
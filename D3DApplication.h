@@ -1,11 +1,25 @@
 #pragma once
 #include <Windows.h>
 #include <d3d11.h>
+#include <atomic>
+#include <thread>
+#include "FrameProfiler.h"
+#include "UIHost.h"
 
 struct InjectorUI;
 struct TitleBarUI;
 
-struct D3DApplication {
+// Counters for the render loop, so the cost of the idle window can be checked
+struct FrameStatistics {
+	double LastFrameMilliseconds = 0.0;
+	double AverageFrameMilliseconds = 0.0; // Exponential moving average of the CPU frame time
+	double IdleRatio = 0.0;                // Fraction of the last second spent blocked waiting for events
+	unsigned long long FramesRendered = 0;
+	unsigned long long Wakeups = 0;        // Returns from MsgWaitForMultipleObjectsEx
+	unsigned long long SwapChainResizes = 0; // ResizeBuffers calls after coalescing WM_SIZE
+};
+
+struct D3DApplication : UIHost {
 private:
 	HINSTANCE ApplicationInstance = nullptr;
 	HWND WindowHandle = nullptr; // This will be set AFTER CreateWindowEx returns
@@ -17,17 +31,63 @@ private:
 	InjectorUI* InjectorPanel = nullptr;
 	TitleBarUI* TitleBar = nullptr;
 
+	// The file picker runs on its own thread so the window keeps rendering while it is open
+	std::thread FileDialogThread;
+	std::atomic<bool> FileDialogOpen = false;
+
+	// Event-driven rendering: the loop blocks until input, a resize or RequestRedraw() arrives
+	HANDLE RedrawEvent = nullptr;
+	bool EventDrivenRendering = true;
+	int PendingFrames = 0;
+	static constexpr int SettleFrameCount = 2;              // ImGui needs an extra frame to settle hover/active state
+	static constexpr DWORD AnimationIntervalMilliseconds = 50; // Low-rate tick while something animates (text caret, progress)
+
+	// Flip-model swap chain with a frame-latency waitable object (opt-in, falls back to the blt model)
+	bool UseFlipModel = false;
+	bool TearingSupported = false;
+	UINT SwapChainFlags = 0;                     // Must be passed again to ResizeBuffers
+	HANDLE FrameLatencyWaitableObject = nullptr; // Signalled when the swap chain can take another frame
+
+	// WM_SIZE only records the size; the swap chain is resized once at the start of the next frame
+	UINT PendingWidth = 0;
+	UINT PendingHeight = 0;
+	bool ResizePending = false;
+	bool InSizeMove = false; // Inside the modal sizing/moving loop, which starves RunMessageLoop
+	static constexpr UINT_PTR SizeMoveTimerID = 1;
+	static constexpr UINT SizeMoveFrameMilliseconds = 16;
+
+	LARGE_INTEGER TimerFrequency = {};
+	FrameStatistics Statistics;
+	FrameProfiler Profiler;
+
 	bool CreateDeviceAndSwapChain();
+	bool TryCreateDeviceAndSwapChain(bool FlipModel, HRESULT& Result);
 	void DestroyDeviceAndSwapChain();
+	void RenderFrame();
+	void ApplyPendingResize();
+	bool WantsAnimation() const;
 
 public:
 	explicit D3DApplication(HINSTANCE ApplicationInstance);
-	~D3DApplication();
+	~D3DApplication() override;
 
 	bool Initialize(int PositionX, int PositionY, int Width, int Height);
 	void RunMessageLoop();
 	void Shutdown();
 
+	void SetEventDrivenRendering(bool Enabled) { EventDrivenRendering = Enabled; }
+	// Must be called before Initialize()
+	void SetFlipModelSwapChain(bool Enabled) { UseFlipModel = Enabled; }
+	const FrameStatistics& GetFrameStatistics() const { return Statistics; }
+
+	// UIHost
+	void RequestRedraw() override; // Thread-safe: wakes the message loop so background results get drawn
+	void RequestMinimize() override;
+	void RequestClose() override;
+	void ScreenToClientPoint(float& X, float& Y) const override;
+	bool BrowseForDLL(std::function<void(std::string)> OnChosen) override;
+	std::filesystem::path DataDirectory() const override;
+
 	// Modified to accept HWND
 	LRESULT HandleWindowMessage(HWND hwnd, UINT Message, WPARAM WParam, LPARAM LParam);
 	static D3DApplication* Instance;
@@ -1,16 +1,31 @@
 #include "FileDialog.h"
 #include <commdlg.h>
+#include <objbase.h> // For CoInitializeEx
 
 #pragma comment(lib, "comdlg32.lib")
+#pragma comment(lib, "ole32.lib")
 
-bool FileDialog::SelectDLL(HWND OwnerHWND, char *OutFilePath, DWORD MaxFilePathLength) {
-	OPENFILENAMEA OpenFileName = {};
+bool FileDialog::SelectDLL(HWND OwnerHWND, std::wstring& OutFilePath) {
+	// The dialog hosts shell extensions, which expect a single-threaded apartment on the calling thread
+	const HRESULT ComResult = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);
+
+	std::wstring FilePath(32768, L'\0'); // The longest path Windows supports, so nothing is truncated
+	OPENFILENAMEW OpenFileName = {};
 	OpenFileName.lStructSize = sizeof(OpenFileName);
 	OpenFileName.hwndOwner = OwnerHWND;
-	OpenFileName.lpstrFile = OutFilePath;
-	OpenFileName.nMaxFile = MaxFilePathLength;
-	OpenFileName.lpstrFilter = "DLL Files\0*.dll\0All Files\0*.*\0";
-	OpenFileName.lpstrTitle = "Select DLL to Inject";
+	OpenFileName.lpstrFile = FilePath.data();
+	OpenFileName.nMaxFile = static_cast<DWORD>(FilePath.size());
+	OpenFileName.lpstrFilter = L"DLL Files\0*.dll\0All Files\0*.*\0";
+	OpenFileName.lpstrTitle = L"Select DLL to Inject";
 	OpenFileName.Flags = OFN_FILEMUSTEXIST | OFN_PATHMUSTEXIST | OFN_NOCHANGEDIR;
-	return GetOpenFileNameA(&OpenFileName) == TRUE;
+	const bool Chosen = GetOpenFileNameW(&OpenFileName) == TRUE;
+	if (Chosen) {
+		FilePath.resize(wcslen(FilePath.c_str()));
+		OutFilePath = std::move(FilePath);
+	}
+
+	if (SUCCEEDED(ComResult)) {
+		CoUninitialize();
+	}
+	return Chosen;
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <Windows.h>
+#include <string>
 
 struct FileDialog {
-	static bool SelectDLL(HWND OwnerHWND, char* OutFilePath, DWORD MaxFilePathLength);
+	// Blocks until the user picks a file or cancels; run it off the render thread
+	static bool SelectDLL(HWND OwnerHWND, std::wstring& OutFilePath);
 };
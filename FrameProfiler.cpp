@@ -0,0 +1,216 @@
+#include "FrameProfiler.h"
+#include "D3DApplication.h"
+#include "StartupTrace.h"
+#include <imgui.h>
+#include <algorithm>
+#include <cstdio>
+
+bool FrameProfiler::Initialize(ID3D11Device* Device, ID3D11DeviceContext* Context) {
+	QueryPerformanceFrequency(&TimerFrequency);
+	DeviceContext = Context;
+
+	D3D11_QUERY_DESC DisjointDescription = { D3D11_QUERY_TIMESTAMP_DISJOINT, 0 };
+	D3D11_QUERY_DESC TimestampDescription = { D3D11_QUERY_TIMESTAMP, 0 };
+	for (GpuQuerySet& Set : Queries) {
+		if (FAILED(Device->CreateQuery(&DisjointDescription, &Set.Disjoint)) ||
+			FAILED(Device->CreateQuery(&TimestampDescription, &Set.Begin)) ||
+			FAILED(Device->CreateQuery(&TimestampDescription, &Set.End))) {
+			OutputDebugStringW(L"FrameProfiler: timestamp queries unavailable, GPU time disabled.\n");
+			Shutdown();
+			DeviceContext = Context; // CPU timings still work
+			return false;
+		}
+	}
+	return true;
+}
+
+void FrameProfiler::Shutdown() {
+	for (GpuQuerySet& Set : Queries) {
+		if (Set.Disjoint) { Set.Disjoint->Release(); Set.Disjoint = nullptr; }
+		if (Set.Begin) { Set.Begin->Release(); Set.Begin = nullptr; }
+		if (Set.End) { Set.End->Release(); Set.End = nullptr; }
+		Set.Pending = false;
+	}
+	DeviceContext = nullptr;
+}
+
+void FrameProfiler::BeginPhase(ProfilePhase Phase) {
+	QueryPerformanceCounter(&PhaseStart[static_cast<int>(Phase)]);
+}
+
+void FrameProfiler::EndPhase(ProfilePhase Phase) {
+	LARGE_INTEGER Now;
+	QueryPerformanceCounter(&Now);
+	const int Index = static_cast<int>(Phase);
+	CurrentSample().PhaseMilliseconds[Index] =
+		static_cast<double>(Now.QuadPart - PhaseStart[Index].QuadPart) * 1000.0 / static_cast<double>(TimerFrequency.QuadPart);
+}
+
+void FrameProfiler::BeginGpu() {
+	GpuQuerySet& Set = Queries[FrameNumber % QueryLatency];
+	if (!Set.Disjoint || !DeviceContext) {
+		return;
+	}
+	// A slot still pending here means the GPU fell more than QueryLatency frames behind; drop that result
+	Set.Pending = false;
+	DeviceContext->Begin(Set.Disjoint);
+	DeviceContext->End(Set.Begin);
+}
+
+void FrameProfiler::EndGpu() {
+	GpuQuerySet& Set = Queries[FrameNumber % QueryLatency];
+	if (!Set.Disjoint || !DeviceContext) {
+		return;
+	}
+	DeviceContext->End(Set.End);
+	DeviceContext->End(Set.Disjoint);
+	Set.Frame = FrameNumber;
+	Set.Pending = true;
+}
+
+void FrameProfiler::CollectGpuResults() {
+	for (GpuQuerySet& Set : Queries) {
+		if (!Set.Pending || Set.Frame == FrameNumber) {
+			continue;
+		}
+		D3D11_QUERY_DATA_TIMESTAMP_DISJOINT Disjoint = {};
+		UINT64 Begin = 0, End = 0;
+		if (DeviceContext->GetData(Set.Disjoint, &Disjoint, sizeof(Disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+			DeviceContext->GetData(Set.Begin, &Begin, sizeof(Begin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+			DeviceContext->GetData(Set.End, &End, sizeof(End), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+			continue; // Not ready yet, try again next frame
+		}
+		Set.Pending = false;
+		FrameSample& Sample = Samples[Set.Frame % SampleCount];
+		if (Sample.Frame != Set.Frame || Disjoint.Disjoint || Disjoint.Frequency == 0) {
+			continue; // Sample slot reused, or the clock changed during the frame
+		}
+		Sample.GpuMilliseconds = static_cast<double>(End - Begin) * 1000.0 / static_cast<double>(Disjoint.Frequency);
+	}
+}
+
+void FrameProfiler::EndFrame(const ImDrawData* DrawData) {
+	FrameSample& Sample = CurrentSample();
+	Sample.Frame = FrameNumber;
+	Sample.GpuMilliseconds = -1.0;
+	Sample.CpuMilliseconds = 0.0;
+	for (double PhaseMilliseconds : Sample.PhaseMilliseconds) {
+		Sample.CpuMilliseconds += PhaseMilliseconds;
+	}
+	Sample.DrawCalls = 0;
+	Sample.Vertices = DrawData ? DrawData->TotalVtxCount : 0;
+	Sample.Indices = DrawData ? DrawData->TotalIdxCount : 0;
+	if (DrawData) {
+		for (int ListIndex = 0; ListIndex < DrawData->CmdListsCount; ++ListIndex) {
+			Sample.DrawCalls += DrawData->CmdLists[ListIndex]->CmdBuffer.Size;
+		}
+	}
+
+	if (DeviceContext && Queries[0].Disjoint) {
+		CollectGpuResults();
+	}
+	FrameNumber++;
+	// Clear the phases of the next slot so skipped phases don't report stale values
+	FrameSample& Next = CurrentSample();
+	std::fill(std::begin(Next.PhaseMilliseconds), std::end(Next.PhaseMilliseconds), 0.0);
+}
+
+bool FrameProfiler::DumpCsv() {
+	WCHAR DumpPath[MAX_PATH];
+	DWORD Length = GetModuleFileNameW(nullptr, DumpPath, MAX_PATH);
+	WCHAR* FileName = (Length > 0 && Length < MAX_PATH) ? wcsrchr(DumpPath, L'\\') : nullptr;
+	if (!FileName || (FileName - DumpPath) + 20 >= MAX_PATH) {
+		return false;
+	}
+	wcscpy_s(FileName + 1, MAX_PATH - (FileName + 1 - DumpPath), L"FrameProfile.csv");
+
+	FILE* File = nullptr;
+	if (_wfopen_s(&File, DumpPath, L"wb") != 0 || !File) {
+		return false;
+	}
+	std::fputs("frame,new_frame_ms,title_bar_ms,injector_ms,imgui_render_ms,render_draw_data_ms,cpu_ms,gpu_ms,draw_calls,vertices,indices\n", File);
+	for (unsigned long long Frame = FrameNumber - CompletedFrames(); Frame < FrameNumber; ++Frame) {
+		const FrameSample& Sample = Samples[Frame % SampleCount];
+		std::fprintf(File, "%llu,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%d,%d,%d\n", Sample.Frame,
+			Sample.PhaseMilliseconds[0], Sample.PhaseMilliseconds[1], Sample.PhaseMilliseconds[2],
+			Sample.PhaseMilliseconds[3], Sample.PhaseMilliseconds[4], Sample.CpuMilliseconds,
+			Sample.GpuMilliseconds, Sample.DrawCalls, Sample.Vertices, Sample.Indices);
+	}
+	std::fclose(File);
+	return true;
+}
+
+void FrameProfiler::RenderOverlay(const FrameStatistics& LoopStatistics) {
+	if (ImGui::IsKeyPressed(ImGuiKey_F3, false)) {
+		Visible = !Visible;
+	}
+	if (!Visible) {
+		return;
+	}
+
+	const ImGuiViewport* Viewport = ImGui::GetMainViewport();
+	ImGui::SetNextWindowPos(ImVec2(Viewport->Pos.x + Viewport->Size.x - 10.0f, Viewport->Pos.y + 40.0f), ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+	ImGui::SetNextWindowBgAlpha(0.85f);
+	if (!ImGui::Begin("Frame Profiler", &Visible, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing)) {
+		ImGui::End();
+		return;
+	}
+
+	static const char* const PhaseNames[PhaseCount] = { "NewFrame", "TitleBarUI", "InjectorUI", "ImGui::Render", "RenderDrawData" };
+	const FrameSample& Last = Samples[(FrameNumber + SampleCount - 1) % SampleCount];
+	// GPU results arrive QueryLatency or more frames late, so show the newest one that has resolved
+	double LastGpuMilliseconds = -1.0;
+	for (unsigned long long Age = 1; Age <= CompletedFrames() && LastGpuMilliseconds < 0.0; ++Age) {
+		LastGpuMilliseconds = Samples[(FrameNumber - Age) % SampleCount].GpuMilliseconds;
+	}
+
+	if (ImGui::BeginTable("##ProfilerTable", 5, ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_RowBg)) {
+		ImGui::TableSetupColumn("ms");
+		ImGui::TableSetupColumn("last");
+		ImGui::TableSetupColumn("p50");
+		ImGui::TableSetupColumn("p95");
+		ImGui::TableSetupColumn("p99");
+		ImGui::TableHeadersRow();
+
+		auto PercentileRow = [&](const char* Name, double LastValue, auto ValueOf) {
+			double Values[SampleCount];
+			int Count = 0;
+			for (unsigned long long Frame = FrameNumber - CompletedFrames(); Frame < FrameNumber; ++Frame) {
+				const double Value = ValueOf(Samples[Frame % SampleCount]);
+				if (Value >= 0.0) {
+					Values[Count++] = Value;
+				}
+			}
+			std::sort(Values, Values + Count);
+			auto At = [&](double Fraction) { return Count ? Values[std::min(Count - 1, static_cast<int>(Fraction * Count))] : 0.0; };
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn(); ImGui::TextUnformatted(Name);
+			ImGui::TableNextColumn(); LastValue >= 0.0 ? ImGui::Text("%.3f", LastValue) : ImGui::TextDisabled("-");
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", At(0.50));
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", At(0.95));
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", At(0.99));
+		};
+		for (int Phase = 0; Phase < PhaseCount; ++Phase) {
+			PercentileRow(PhaseNames[Phase], Last.PhaseMilliseconds[Phase], [Phase](const FrameSample& Sample) { return Sample.PhaseMilliseconds[Phase]; });
+		}
+		PercentileRow("CPU total", Last.CpuMilliseconds, [](const FrameSample& Sample) { return Sample.CpuMilliseconds; });
+		PercentileRow("GPU", LastGpuMilliseconds, [](const FrameSample& Sample) { return Sample.GpuMilliseconds; });
+		ImGui::EndTable();
+	}
+
+	ImGui::Text("Draw calls %d  vertices %d  indices %d", Last.DrawCalls, Last.Vertices, Last.Indices);
+	ImGui::Text("Frames %llu  idle ratio %.2f  resizes %llu", LoopStatistics.FramesRendered, LoopStatistics.IdleRatio, LoopStatistics.SwapChainResizes);
+	if (ImGui::Button("Dump CSV")) {
+		std::snprintf(DumpMessage, sizeof(DumpMessage), DumpCsv() ? "Wrote FrameProfile.csv" : "Could not write FrameProfile.csv");
+	}
+	if (DumpMessage[0] != '\0') {
+		ImGui::SameLine();
+		ImGui::TextUnformatted(DumpMessage);
+	}
+	if (ImGui::CollapsingHeader("Startup")) {
+		for (const StartupTrace::Step& Step : StartupTrace::Global().Steps()) {
+			ImGui::Text("%9.2f ms  %s", Step.Milliseconds, Step.Name.c_str());
+		}
+	}
+	ImGui::End();
+}
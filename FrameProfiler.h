@@ -0,0 +1,71 @@
+#pragma once
+#include <Windows.h>
+#include <d3d11.h>
+
+struct ImDrawData;
+struct FrameStatistics;
+
+enum class ProfilePhase {
+	NewFrame,       // Backend NewFrame calls plus ImGui::NewFrame
+	TitleBar,       // TitleBarUI::Render
+	InjectorPanel,  // InjectorUI::Render
+	ImGuiRender,    // ImGui::Render
+	RenderDrawData, // ImGui_ImplDX11_RenderDrawData
+	Count
+};
+
+// Toggleable (F3) overlay with per-phase CPU time, GPU time from timestamp queries and ImDrawData
+// counts. GPU queries are read back a few frames late with DONOTFLUSH, so the profiler never stalls.
+struct FrameProfiler {
+private:
+	static constexpr int PhaseCount = static_cast<int>(ProfilePhase::Count);
+	static constexpr int SampleCount = 240;  // Rolling window for the percentiles and the CSV dump
+	static constexpr int QueryLatency = 4;   // Frames in flight before a GPU result is expected
+
+	struct FrameSample {
+		unsigned long long Frame = 0;
+		double PhaseMilliseconds[PhaseCount] = {};
+		double CpuMilliseconds = 0.0;
+		double GpuMilliseconds = -1.0; // Negative until the timestamp queries resolve
+		int DrawCalls = 0;
+		int Vertices = 0;
+		int Indices = 0;
+	};
+
+	struct GpuQuerySet {
+		ID3D11Query* Disjoint = nullptr;
+		ID3D11Query* Begin = nullptr;
+		ID3D11Query* End = nullptr;
+		unsigned long long Frame = 0;
+		bool Pending = false;
+	};
+
+	ID3D11DeviceContext* DeviceContext = nullptr;
+	GpuQuerySet Queries[QueryLatency];
+	FrameSample Samples[SampleCount];
+	unsigned long long FrameNumber = 0; // Frames recorded so far
+	LARGE_INTEGER TimerFrequency = {};
+	LARGE_INTEGER PhaseStart[PhaseCount] = {};
+	bool Visible = false;
+	char DumpMessage[128] = "";
+
+	FrameSample& CurrentSample() { return Samples[FrameNumber % SampleCount]; }
+	// Finished frames still in Samples: the current frame's slot is being overwritten, so one less than SampleCount
+	unsigned long long CompletedFrames() const { return FrameNumber < SampleCount ? FrameNumber : SampleCount - 1; }
+	void CollectGpuResults();
+	bool DumpCsv();
+
+public:
+	bool Initialize(ID3D11Device* Device, ID3D11DeviceContext* DeviceContext);
+	void Shutdown();
+
+	void BeginPhase(ProfilePhase Phase);
+	void EndPhase(ProfilePhase Phase);
+	void BeginGpu();
+	void EndGpu();
+	void EndFrame(const ImDrawData* DrawData);
+
+	// Call between ImGui::NewFrame and ImGui::Render; handles the F3 toggle as well
+	void RenderOverlay(const FrameStatistics& LoopStatistics);
+	bool IsVisible() const { return Visible; }
+};
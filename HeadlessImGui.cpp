@@ -0,0 +1,39 @@
+#include "HeadlessImGui.h"
+
+HeadlessImGui::HeadlessImGui(float Width, float Height, float FrameSeconds) : FrameSeconds(FrameSeconds) {
+	IMGUI_CHECKVERSION();
+	Context = ImGui::CreateContext();
+	ImGui::SetCurrentContext(Context);
+	ImGui::StyleColorsDark();
+
+	ImGuiIO& IO = ImGui::GetIO();
+	IO.IniFilename = nullptr; // Runs must not depend on, or leave behind, imgui.ini
+	IO.LogFilename = nullptr;
+	IO.BackendPlatformName = "headless";
+	IO.BackendRendererName = "null";
+	IO.DisplaySize = ImVec2(Width, Height);
+
+	// NewFrame asserts on an unbuilt atlas; the pixels are simply dropped
+	unsigned char* Pixels = nullptr;
+	int AtlasWidth = 0, AtlasHeight = 0;
+	IO.Fonts->GetTexDataAsAlpha8(&Pixels, &AtlasWidth, &AtlasHeight);
+	IO.Fonts->SetTexID((ImTextureID)1);
+}
+
+HeadlessImGui::~HeadlessImGui() {
+	ImGui::DestroyContext(Context);
+}
+
+void HeadlessImGui::SetDisplaySize(float Width, float Height) {
+	ImGui::GetIO().DisplaySize = ImVec2(Width, Height);
+}
+
+void HeadlessImGui::NewFrame() {
+	ImGui::GetIO().DeltaTime = FrameSeconds;
+	ImGui::NewFrame();
+}
+
+const ImDrawData* HeadlessImGui::Render() {
+	ImGui::Render();
+	return ImGui::GetDrawData();
+}
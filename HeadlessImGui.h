@@ -0,0 +1,37 @@
+#pragma once
+#include "UIHost.h"
+#include <imgui.h>
+#include <atomic>
+
+// UIHost for running the panels without a window: counts redraw requests and ignores window commands
+struct HeadlessUIHost : UIHost {
+	std::atomic<unsigned long long> RedrawRequests{ 0 };
+	std::filesystem::path Directory = std::filesystem::temp_directory_path();
+
+	void RequestRedraw() override { RedrawRequests.fetch_add(1, std::memory_order_release); }
+	void RequestMinimize() override {}
+	void RequestClose() override {}
+	void ScreenToClientPoint(float&, float&) const override {}
+	bool BrowseForDLL(std::function<void(std::string)>) override { return false; }
+	std::filesystem::path DataDirectory() const override { return Directory; }
+};
+
+// Platform and renderer backend with no output device. The font atlas is built but never uploaded,
+// time advances by a fixed step per frame, and input only arrives through the io.Add*Event calls.
+struct HeadlessImGui {
+private:
+	ImGuiContext* Context = nullptr;
+	float FrameSeconds;
+
+public:
+	explicit HeadlessImGui(float Width = 500.0f, float Height = 500.0f, float FrameSeconds = 1.0f / 60.0f);
+	~HeadlessImGui();
+
+	HeadlessImGui(const HeadlessImGui&) = delete;
+	HeadlessImGui& operator=(const HeadlessImGui&) = delete;
+
+	void SetDisplaySize(float Width, float Height);
+	void NewFrame();
+	// Ends the frame and returns the draw lists a renderer would have consumed
+	const ImDrawData* Render();
+};
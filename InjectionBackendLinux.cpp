@@ -0,0 +1,18 @@
+#include "InjectionWorker.h"
+
+// Keeps InjectionWorker and the UI usable off Windows (headless harness, CI); nothing is injected
+struct UnsupportedInjectionBackend : InjectionBackend {
+	InjectionStatus Inject(const std::string&, ProcessID, std::uint32_t) override {
+		InjectionStatus Status;
+		Status.State = InjectionState::Failed;
+		Status.Message = "DLL injection is only supported on Windows.";
+		return Status;
+	}
+
+	void Cancel() override {}
+	void ResetCancel() override {}
+};
+
+std::unique_ptr<InjectionBackend> CreatePlatformInjectionBackend() {
+	return std::make_unique<UnsupportedInjectionBackend>();
+}
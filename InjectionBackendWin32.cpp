@@ -0,0 +1,152 @@
+#include "InjectionWorker.h"
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#include <cstdio> // For sprintf_s
+#include "TextConversion.h"
+
+// Times one step with the high-resolution clock and captures GetLastError before anything else can reset it
+struct StageTimer {
+	InjectionStatus& Status;
+	const char* Name;
+	std::chrono::high_resolution_clock::time_point Start = std::chrono::high_resolution_clock::now();
+
+	bool Finish(bool Succeeded) {
+		const DWORD ErrorCode = Succeeded ? 0 : GetLastError();
+		const double Microseconds = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - Start).count();
+		Status.Stages.push_back({ Name, Microseconds, ErrorCode, Succeeded });
+		if (!Succeeded) {
+			Status.State = InjectionState::Failed;
+			Status.ErrorCode = ErrorCode;
+			char Message[160];
+			sprintf_s(Message, sizeof(Message), "%s failed (error %lu)", Name, ErrorCode);
+			Status.Message = Message;
+		}
+		return Succeeded;
+	}
+};
+
+// Writes the path into the target as UTF-16 and runs LoadLibraryW there on a remote thread,
+// so non-ASCII paths load regardless of the target's ANSI code page
+struct RemoteThreadInjectionBackend : InjectionBackend {
+	HANDLE CancelEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr); // Manual-reset, signalled by Cancel()
+
+	~RemoteThreadInjectionBackend() override {
+		if (CancelEvent) {
+			CloseHandle(CancelEvent);
+		}
+	}
+
+	void Cancel() override {
+		if (CancelEvent) {
+			SetEvent(CancelEvent);
+		}
+	}
+
+	void ResetCancel() override {
+		if (CancelEvent) {
+			ResetEvent(CancelEvent);
+		}
+	}
+
+	InjectionStatus Inject(const std::string& DLLPath, ProcessID TargetProcessID, std::uint32_t TimeoutMilliseconds) override;
+};
+
+// Injection logic
+InjectionStatus RemoteThreadInjectionBackend::Inject(const std::string& DLLPath, ProcessID TargetProcessID, std::uint32_t TimeoutMilliseconds) {
+	InjectionStatus Status;
+	StageTimer OpenStage{ Status, "OpenProcess" };
+	HANDLE ProcessHandle = OpenProcess(PROCESS_ALL_ACCESS, FALSE, TargetProcessID);
+	if (!OpenStage.Finish(ProcessHandle != nullptr)) {
+		return Status;
+	}
+
+	const std::wstring WidePath = WideFromUtf8(DLLPath);
+	SIZE_T PathBytes = (WidePath.size() + 1) * sizeof(wchar_t); // +1 for null terminator
+	StageTimer AllocateStage{ Status, "VirtualAllocEx" };
+	void* RemoteBuffer = VirtualAllocEx(ProcessHandle, nullptr, PathBytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+	if (!AllocateStage.Finish(RemoteBuffer != nullptr)) {
+		CloseHandle(ProcessHandle);
+		return Status;
+	}
+
+	StageTimer WriteStage{ Status, "WriteProcessMemory" };
+	if (!WriteStage.Finish(WriteProcessMemory(ProcessHandle, RemoteBuffer, WidePath.c_str(), PathBytes, nullptr) != FALSE)) {
+		VirtualFreeEx(ProcessHandle, RemoteBuffer, 0, MEM_RELEASE);
+		CloseHandle(ProcessHandle);
+		return Status;
+	}
+
+	StageTimer ResolveStage{ Status, "GetProcAddress" };
+	HMODULE kernel32Handle = GetModuleHandle(TEXT("kernel32.dll"));
+	FARPROC LoadLibraryAddress = kernel32Handle ? GetProcAddress(kernel32Handle, "LoadLibraryW") : nullptr;
+	if (!ResolveStage.Finish(LoadLibraryAddress != nullptr)) {
+		VirtualFreeEx(ProcessHandle, RemoteBuffer, 0, MEM_RELEASE);
+		CloseHandle(ProcessHandle);
+		return Status;
+	}
+
+	StageTimer ThreadStage{ Status, "CreateRemoteThread" };
+	HANDLE RemoteThreadHandle = CreateRemoteThread(ProcessHandle, nullptr, 0, (LPTHREAD_START_ROUTINE)LoadLibraryAddress, RemoteBuffer, 0, nullptr);
+	if (!ThreadStage.Finish(RemoteThreadHandle != nullptr)) {
+		VirtualFreeEx(ProcessHandle, RemoteBuffer, 0, MEM_RELEASE);
+		CloseHandle(ProcessHandle);
+		return Status;
+	}
+
+	bool RemoteThreadFinished = false;
+	HANDLE WaitHandles[2] = { RemoteThreadHandle, CancelEvent };
+	StageTimer WaitStage{ Status, "WaitForRemoteThread" };
+	// Without a cancel event (CreateEventW failed) the wait can only end by completion or timeout
+	const DWORD WaitHandleCount = CancelEvent ? 2 : 1;
+	DWORD WaitResult = WaitForMultipleObjects(WaitHandleCount, WaitHandles, FALSE, TimeoutMilliseconds);
+	switch (WaitResult) {
+		case WAIT_OBJECT_0: {
+			WaitStage.Finish(true);
+			RemoteThreadFinished = true;
+			StageTimer ExitCodeStage{ Status, "GetExitCodeThread" };
+			DWORD ExitCode = 0;
+			if (!ExitCodeStage.Finish(GetExitCodeThread(RemoteThreadHandle, &ExitCode) != FALSE)) {
+				break;
+			}
+			Status.ExitCode = ExitCode;
+			if (Status.ExitCode == 0) {
+				// LoadLibraryW returned NULL inside the target
+				Status.State = InjectionState::Failed;
+				Status.Message = "LoadLibraryW returned NULL in the target process. Check the DLL path, its dependencies and the target architecture (32/64-bit).";
+			} else {
+				Status.State = InjectionState::Succeeded;
+				char Message[96];
+				sprintf_s(Message, sizeof(Message), "DLL loaded (module handle low bits 0x%08X).", Status.ExitCode);
+				Status.Message = Message;
+			}
+			break;
+		}
+		case WAIT_OBJECT_0 + 1:
+			WaitStage.Finish(true);
+			Status.State = InjectionState::Cancelled;
+			Status.Message = "Cancelled. The remote thread may still be running in the target.";
+			break;
+		case WAIT_TIMEOUT:
+			WaitStage.Finish(true);
+			Status.State = InjectionState::TimedOut;
+			Status.Message = "Timed out waiting for the remote thread (DllMain may be hung).";
+			break;
+		default:
+			WaitStage.Finish(false);
+			break;
+	}
+	CloseHandle(RemoteThreadHandle);
+
+	// The path buffer can only be released once LoadLibraryW is done reading it
+	if (RemoteThreadFinished) {
+		VirtualFreeEx(ProcessHandle, RemoteBuffer, 0, MEM_RELEASE);
+	}
+	CloseHandle(ProcessHandle);
+	return Status;
+}
+
+std::unique_ptr<InjectionBackend> CreatePlatformInjectionBackend() {
+	return std::make_unique<RemoteThreadInjectionBackend>();
+}
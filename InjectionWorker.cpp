@@ -0,0 +1,133 @@
+#include "InjectionWorker.h"
+#include <cstdio> // For snprintf
+
+InjectionWorker::InjectionWorker(std::unique_ptr<InjectionBackend> Backend, std::function<void()> OnFinished)
+	: Backend(std::move(Backend)), OnFinished(std::move(OnFinished)) {}
+
+InjectionWorker::~InjectionWorker() {
+	// Stop waiting on a hung remote thread so shutdown is not held up by the target
+	Cancel();
+	if (Worker.joinable()) {
+		Worker.join();
+	}
+}
+
+bool InjectionWorker::Start(std::string DLLPath, ProcessID TargetProcessID, std::uint32_t TimeoutMilliseconds) {
+	{
+		std::lock_guard Lock(StatusMutex);
+		if (CurrentStatus.State == InjectionState::Running) {
+			return false;
+		}
+		CurrentStatus = {};
+		CurrentStatus.State = InjectionState::Running;
+		CurrentStatus.Sequence = NextSequence++;
+		CurrentStatus.TargetPID = TargetProcessID;
+		CurrentStatus.DLLPath = DLLPath;
+		CurrentStatus.WallClockStart = std::chrono::system_clock::now();
+		CurrentStatus.StartTime = std::chrono::steady_clock::now();
+	}
+	if (Worker.joinable()) {
+		Worker.join(); // Previous operation has already published its result
+	}
+	Backend->ResetCancel();
+	Worker = std::thread(&InjectionWorker::Run, this, std::move(DLLPath), TargetProcessID, TimeoutMilliseconds);
+	return true;
+}
+
+void InjectionWorker::Cancel() {
+	Backend->Cancel();
+}
+
+bool InjectionWorker::IsRunning() const {
+	std::lock_guard Lock(StatusMutex);
+	return CurrentStatus.State == InjectionState::Running;
+}
+
+InjectionStatus InjectionWorker::Status() const {
+	std::lock_guard Lock(StatusMutex);
+	return CurrentStatus;
+}
+
+void InjectionWorker::Run(std::string DLLPath, ProcessID TargetProcessID, std::uint32_t TimeoutMilliseconds) {
+	InjectionStatus Result;
+	if (DLLPath.empty() || TargetProcessID == 0) {
+		// Basic validation
+		Result.State = InjectionState::Failed;
+		Result.Message = "Please ensure DLL path and Target PID are valid.";
+	} else {
+		Result = Backend->Inject(DLLPath, TargetProcessID, TimeoutMilliseconds);
+	}
+	{
+		std::lock_guard Lock(StatusMutex);
+		Result.Sequence = CurrentStatus.Sequence;
+		Result.TargetPID = TargetProcessID;
+		Result.DLLPath = std::move(CurrentStatus.DLLPath);
+		Result.WallClockStart = CurrentStatus.WallClockStart;
+		Result.StartTime = CurrentStatus.StartTime;
+		Result.EndTime = std::chrono::steady_clock::now();
+		CurrentStatus = std::move(Result);
+	}
+	if (OnFinished) {
+		OnFinished();
+	}
+}
+
+const char* ToString(InjectionState State) {
+	switch (State) {
+		case InjectionState::Idle: return "Idle";
+		case InjectionState::Running: return "Running";
+		case InjectionState::Succeeded: return "Succeeded";
+		case InjectionState::Failed: return "Failed";
+		case InjectionState::TimedOut: return "TimedOut";
+		case InjectionState::Cancelled: return "Cancelled";
+	}
+	return "Unknown";
+}
+
+static void AppendJsonString(std::string& Out, std::string_view Text) {
+	Out += '"';
+	for (char c : Text) {
+		switch (c) {
+			case '"': Out += "\\\""; break;
+			case '\\': Out += "\\\\"; break;
+			case '\n': Out += "\\n"; break;
+			case '\r': Out += "\\r"; break;
+			case '\t': Out += "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					char Escaped[8];
+					std::snprintf(Escaped, sizeof(Escaped), "\\u%04X", static_cast<unsigned>(c));
+					Out += Escaped;
+				} else {
+					Out += c; // UTF-8 passes through unchanged
+				}
+		}
+	}
+	Out += '"';
+}
+
+std::string ToJsonLine(const InjectionStatus& Status) {
+	const long long UnixMilliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(Status.WallClockStart.time_since_epoch()).count();
+	const double TotalMicroseconds = std::chrono::duration<double, std::micro>(Status.EndTime - Status.StartTime).count();
+
+	char Buffer[256];
+	std::string Line;
+	std::snprintf(Buffer, sizeof(Buffer), "{\"timestamp_ms\":%lld,\"pid\":%u,\"dll\":", UnixMilliseconds, Status.TargetPID);
+	Line += Buffer;
+	AppendJsonString(Line, Status.DLLPath);
+	Line += ",\"state\":";
+	AppendJsonString(Line, ToString(Status.State));
+	std::snprintf(Buffer, sizeof(Buffer), ",\"exit_code\":%u,\"error\":%u,\"total_us\":%.1f,\"message\":", Status.ExitCode, Status.ErrorCode, TotalMicroseconds);
+	Line += Buffer;
+	AppendJsonString(Line, Status.Message);
+	Line += ",\"stages\":[";
+	for (size_t Index = 0; Index < Status.Stages.size(); ++Index) {
+		const InjectionStage& Stage = Status.Stages[Index];
+		Line += Index == 0 ? "{\"name\":" : ",{\"name\":";
+		AppendJsonString(Line, Stage.Name);
+		std::snprintf(Buffer, sizeof(Buffer), ",\"us\":%.1f,\"error\":%u,\"ok\":%s}", Stage.Microseconds, Stage.ErrorCode, Stage.Succeeded ? "true" : "false");
+		Line += Buffer;
+	}
+	Line += "]}";
+	return Line;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "ProcessInfo.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class InjectionState {
+	Idle,
+	Running,
+	Succeeded,
+	Failed,
+	TimedOut,  // The remote thread is still running; its path buffer is left allocated
+	Cancelled, // Same as TimedOut, but requested by the user
+};
+
+// One timed step of the load operation
+struct InjectionStage {
+	const char* Name = "";
+	double Microseconds = 0.0;
+	std::uint32_t ErrorCode = 0; // GetLastError/errno right after the call, 0 on success
+	bool Succeeded = false;
+};
+
+struct InjectionStatus {
+	InjectionState State = InjectionState::Idle;
+	unsigned long long Sequence = 0; // Increases with every started operation
+	ProcessID TargetPID = 0;
+	std::string DLLPath;
+	std::uint32_t ExitCode = 0;  // Remote LoadLibraryW result (low 32 bits of the HMODULE), 0 = NULL
+	std::uint32_t ErrorCode = 0; // Error code of the failing step
+	std::string Message;
+	std::vector<InjectionStage> Stages; // In execution order, up to and including the failing one
+	std::chrono::system_clock::time_point WallClockStart; // For exported records
+	std::chrono::steady_clock::time_point StartTime;
+	std::chrono::steady_clock::time_point EndTime;
+};
+
+const char* ToString(InjectionState State);
+// One JSON object per line, for trending latency and failure causes across machines
+std::string ToJsonLine(const InjectionStatus& Status);
+
+// Platform half of a load operation. Inject() runs on the worker thread and has to return
+// promptly once Cancel() is called from another thread.
+struct InjectionBackend {
+	virtual ~InjectionBackend() = default;
+
+	virtual InjectionStatus Inject(const std::string& DLLPath, ProcessID TargetProcessID, std::uint32_t TimeoutMilliseconds) = 0;
+	virtual void Cancel() = 0;
+	virtual void ResetCancel() = 0; // Called before each Inject()
+};
+
+// CreateRemoteThread + LoadLibraryW on Windows; elsewhere every operation fails as unsupported
+std::unique_ptr<InjectionBackend> CreatePlatformInjectionBackend();
+
+// Runs one load operation at a time off the render thread. The wait on the remote thread is
+// bounded by a timeout and can be cancelled, so a hung DllMain never freezes the UI.
+struct InjectionWorker {
+private:
+	std::thread Worker;
+	std::unique_ptr<InjectionBackend> Backend;
+	mutable std::mutex StatusMutex;
+	InjectionStatus CurrentStatus;
+	unsigned long long NextSequence = 1;
+	std::function<void()> OnFinished; // Called on the worker when an operation completes
+
+	void Run(std::string DLLPath, ProcessID TargetProcessID, std::uint32_t TimeoutMilliseconds);
+
+public:
+	InjectionWorker(std::unique_ptr<InjectionBackend> Backend, std::function<void()> OnFinished);
+	~InjectionWorker();
+
+	InjectionWorker(const InjectionWorker&) = delete;
+	InjectionWorker& operator=(const InjectionWorker&) = delete;
+
+	// Returns false if an operation is already running
+	bool Start(std::string DLLPath, ProcessID TargetProcessID, std::uint32_t TimeoutMilliseconds);
+	void Cancel();
+
+	bool IsRunning() const;
+	InjectionStatus Status() const;
+};
@@ -1,133 +1,429 @@
 // InjectorUI.cpp
 #include "InjectorUI.h"
-#include "FileDialog.h"
-#include <TlHelp32.h> // For process enumeration
+#include "StartupTrace.h"
 #include <imgui.h>
-#include <string>    // For std::stoul, std::wstring
-#include <cstdio>    // For sprintf_s
-#include <cstring>   // For strcpy_s if needed, though less with std::string
-// Windows.h is likely included by TlHelp32.h, but ensure it's available for MultiByteToWideChar
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN
-#endif
-#include <windows.h>
+#include <misc/cpp/imgui_stdlib.h> // For ImGui::InputText over std::string
+#include <algorithm> // For std::lower_bound
+#include <cctype>    // For std::tolower
+#include <charconv>  // For std::from_chars
+#include <ctime>     // For localtime_s/localtime_r, strftime
+#include <fstream>   // For std::ofstream
+#include <string>    // For std::string
+#include <cstdio>    // For snprintf
+#include <cstring>   // For strlen
 
 
 // Constructor
-InjectorUI::InjectorUI(HWND OwnerHWND) : OwnerHWND(OwnerHWND) {
-	DLLPathBuffer[0] = '\0';
+InjectorUI::InjectorUI(UIHost& Host, std::unique_ptr<ProcessSource> EnumerationSource, std::unique_ptr<ProcessSource> MetadataSource,
+	std::unique_ptr<ProcessSource> ModuleSource, std::unique_ptr<InjectionBackend> Injection)
+	: Host(Host), RecentDLLs(Host.DataDirectory() / "RecentDLLs.txt"),
+	Enumerator(std::move(EnumerationSource), [this] { this->Host.RequestRedraw(); }),
+	MetadataCache(std::move(MetadataSource), [this] { this->Host.RequestRedraw(); }),
+	ModuleCache(std::move(ModuleSource), [this] { this->Host.RequestRedraw(); }),
+	Injector(std::move(Injection), [this] { this->Host.RequestRedraw(); }) {
 	PIDInputBuffer[0] = '\0';
-	RefreshProcessIDList();
+	ProcessFilterBuffer[0] = '\0';
 }
 
 // Destructor
 InjectorUI::~InjectorUI() {}
 
-// Refresh the list of processes
-void InjectorUI::RefreshProcessIDList() {
-	ProcessInfoList.clear();
-	HANDLE SnapshotHandle = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-	if (SnapshotHandle == INVALID_HANDLE_VALUE) {
+void InjectorUI::StartBackgroundWork() {
+	Enumerator.Start();
+}
+
+// True while the status panel shows live progress, so the render loop keeps ticking
+bool InjectorUI::IsAnimating() const {
+	return Injector.IsRunning();
+}
+
+// Loaded modules of the selected process, enumerated only while the header is open
+void InjectorUI::RenderModules() {
+	if (!ImGui::CollapsingHeader("Modules")) {
+		return;
+	}
+	const int row = (Snapshot && SelectedPID != 0) ? Snapshot->FindRow(SelectedPID) : -1;
+	if (row < 0) {
+		ImGui::TextDisabled("Select a process to list its modules.");
+		return;
+	}
+	const ProcessKey key = Snapshot->Processes.Key(row);
+	const std::shared_ptr<const ProcessModuleList> modules = ModuleCache.Get(key);
+	const bool refreshing = ModuleCache.IsRefreshing(key);
+	ImGui::BeginDisabled(refreshing);
+	if (ImGui::Button(refreshing ? "Refreshing..." : "Refresh Modules")) {
+		ModuleCache.Refresh(key);
+	}
+	ImGui::EndDisabled();
+	if (!modules) {
+		return;
+	}
+	if (!modules->available) {
+		ImGui::SameLine();
+		ImGui::TextDisabled("Cannot read this process's modules (access denied or exited).");
 		return;
 	}
 
-	PROCESSENTRY32 ProcessEntry = { sizeof(ProcessEntry) }; // szExeFile is TCHAR
-	if (Process32First(SnapshotHandle, &ProcessEntry)) {
-		do {
-			ProcessInfo info;
-			info.pid = ProcessEntry.th32ProcessID;
+	// Whether the chosen DLL shows up, compared case-insensitively as Windows paths are
+	const ProcessModule* loadedDLL = nullptr;
+	for (const ProcessModule& module : modules->modules) {
+		if (module.path.size() == DLLPath.size() && std::equal(module.path.begin(), module.path.end(), DLLPath.begin(),
+			[](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b)); })) {
+			loadedDLL = &module;
+			break;
+		}
+	}
+	ImGui::SameLine();
+	const size_t addedCount = static_cast<size_t>(std::count_if(modules->modules.begin(), modules->modules.end(), [](const ProcessModule& module) { return module.added; }));
+	ImGui::Text("%zu modules, %zu new, %zu unloaded since the last refresh", modules->modules.size(), addedCount, modules->removedCount);
+	if (loadedDLL) {
+		ImGui::TextColored(ImVec4(0.4f, 0.9f, 0.4f, 1.0f), "Selected DLL is loaded at 0x%llX", static_cast<unsigned long long>(loadedDLL->base));
+	} else if (!DLLPath.empty()) {
+		ImGui::TextDisabled("Selected DLL is not loaded in this process.");
+	}
 
-#ifdef UNICODE
-			// If UNICODE is defined, TCHAR is wchar_t.
-			// ProcessEntry.szExeFile is wchar_t[] and null-terminated.
-			// Direct assignment to std::wstring is safe and efficient.
-			info.processName = ProcessEntry.szExeFile;
-#else
-			// If UNICODE is not defined, TCHAR is char.
-			// ProcessEntry.szExeFile is char[] (ANSI/MBCS) and null-terminated.
-			// We need to explicitly convert it to std::wstring (wchar_t).
-			const char* ansiProcessName = ProcessEntry.szExeFile;
-			if (ansiProcessName[0] == '\0') {
-				info.processName = L""; // Handle empty string case
+	const ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit |
+		ImGuiTableFlags_ScrollY | ImGuiTableFlags_NoSavedSettings;
+	if (!ImGui::BeginTable("##Modules", 3, tableFlags, ImVec2(0.0f, ImGui::GetTextLineHeightWithSpacing() * 10))) {
+		return;
+	}
+	ImGui::TableSetupScrollFreeze(0, 1);
+	ImGui::TableSetupColumn("Base");
+	ImGui::TableSetupColumn("Size");
+	ImGui::TableSetupColumn("Path", ImGuiTableColumnFlags_WidthStretch);
+	ImGui::TableHeadersRow();
+	ImGuiListClipper clipper;
+	clipper.Begin(static_cast<int>(modules->modules.size()));
+	while (clipper.Step()) {
+		for (int index = clipper.DisplayStart; index < clipper.DisplayEnd; ++index) {
+			const ProcessModule& module = modules->modules[index];
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::Text("0x%llX", static_cast<unsigned long long>(module.base));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f KB", static_cast<double>(module.size) / 1024.0);
+			ImGui::TableNextColumn();
+			if (module.added) {
+				ImGui::TextColored(ImVec4(0.4f, 0.9f, 0.4f, 1.0f), "%s", module.path.c_str());
 			} else {
-				// Determine buffer size needed for wide string (including null terminator)
-				int requiredBufferSize = MultiByteToWideChar(CP_ACP, 0, ansiProcessName, -1, nullptr, 0);
-				if (requiredBufferSize > 0) {
-					// std::wstring constructor needs character count, not including its own null.
-					// requiredBufferSize from MultiByteToWideChar (with -1 input length) includes the null.
-					std::wstring wideProcessName(static_cast<size_t>(requiredBufferSize) - 1, L'\0');
-					MultiByteToWideChar(CP_ACP, 0, ansiProcessName, -1, &wideProcessName[0], requiredBufferSize);
-					info.processName = wideProcessName;
-				} else {
-					// Handle conversion error, e.g., log GetLastError()
-					info.processName = L"[Conversion Error]";
-				}
+				ImGui::TextUnformatted(module.path.c_str());
 			}
+		}
+	}
+	ImGui::EndTable();
+}
+
+// Per-operation stage timings; hover a row for the breakdown
+void InjectorUI::RenderHistory() {
+	if (!ImGui::CollapsingHeader("History")) {
+		return;
+	}
+	if (ImGui::Button("Export JSONL")) {
+		ExportHistory();
+	}
+	if (!ExportMessage.empty()) {
+		ImGui::SameLine();
+		ImGui::TextUnformatted(ExportMessage.c_str());
+	}
+
+	const ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit |
+		ImGuiTableFlags_ScrollY | ImGuiTableFlags_NoSavedSettings;
+	if (!ImGui::BeginTable("##InjectionHistory", 5, tableFlags, ImVec2(0.0f, ImGui::GetTextLineHeightWithSpacing() * 8))) {
+		return;
+	}
+	ImGui::TableSetupScrollFreeze(0, 1);
+	ImGui::TableSetupColumn("Time");
+	ImGui::TableSetupColumn("PID");
+	ImGui::TableSetupColumn("Result");
+	ImGui::TableSetupColumn("Total");
+	ImGui::TableSetupColumn("Failed Step", ImGuiTableColumnFlags_WidthStretch);
+	ImGui::TableHeadersRow();
+
+	// Newest first
+	for (auto entry = InjectionHistory.rbegin(); entry != InjectionHistory.rend(); ++entry) {
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn();
+		const std::time_t startTime = std::chrono::system_clock::to_time_t(entry->WallClockStart);
+		std::tm localTime = {};
+		char timeText[16] = "";
+#ifdef _WIN32
+		const bool haveLocalTime = localtime_s(&localTime, &startTime) == 0;
+#else
+		const bool haveLocalTime = localtime_r(&startTime, &localTime) != nullptr;
 #endif
-			ProcessInfoList.push_back(info);
-		} while (Process32Next(SnapshotHandle, &ProcessEntry));
+		if (haveLocalTime) {
+			std::strftime(timeText, sizeof(timeText), "%H:%M:%S", &localTime);
+		}
+		ImGui::PushID(static_cast<int>(entry->Sequence));
+		ImGui::Selectable(timeText, false, ImGuiSelectableFlags_SpanAllColumns);
+		if (ImGui::IsItemHovered() && ImGui::BeginTooltip()) {
+			ImGui::TextUnformatted(entry->DLLPath.c_str());
+			for (const InjectionStage& stage : entry->Stages) {
+				ImGui::Text("%-20s %10.1f us  %s", stage.Name, stage.Microseconds, stage.Succeeded ? "ok" : "failed");
+				if (stage.ErrorCode != 0) {
+					ImGui::SameLine();
+					ImGui::Text("(error %u)", stage.ErrorCode);
+				}
+			}
+			ImGui::EndTooltip();
+		}
+		ImGui::PopID();
+
+		ImGui::TableNextColumn();
+		ImGui::Text("%u", entry->TargetPID);
+		ImGui::TableNextColumn();
+		ImGui::TextUnformatted(ToString(entry->State));
+		ImGui::TableNextColumn();
+		ImGui::Text("%.1f ms", std::chrono::duration<double, std::milli>(entry->EndTime - entry->StartTime).count());
+		ImGui::TableNextColumn();
+		if (!entry->Stages.empty() && !entry->Stages.back().Succeeded) {
+			ImGui::Text("%s (error %u)", entry->Stages.back().Name, entry->Stages.back().ErrorCode);
+		} else if (entry->State == InjectionState::Failed) {
+			ImGui::TextUnformatted(entry->Stages.empty() ? "Validation" : "LoadLibraryW");
+		}
 	}
-	CloseHandle(SnapshotHandle);
+	ImGui::EndTable();
 }
 
-// Injection logic (remains unchanged)
-bool InjectorUI::InjectUsingRemoteThread(const char *DLLPath, DWORD TargetProcessID) {
-	if (DLLPath == nullptr || DLLPath[0] == '\0' || TargetProcessID == 0) {
-        // Basic validation
-		return false;
+// Appends the records not exported yet to InjectionHistory.jsonl in the host's data directory
+void InjectorUI::ExportHistory() {
+	const std::filesystem::path exportPath = Host.DataDirectory() / "InjectionHistory.jsonl";
+	std::ofstream file(exportPath, std::ios::binary | std::ios::app);
+	if (!file) {
+		ExportMessage = "Export failed: could not open InjectionHistory.jsonl.";
+		return;
 	}
-	HANDLE ProcessHandle = OpenProcess(PROCESS_ALL_ACCESS, FALSE, TargetProcessID);
-	if (!ProcessHandle) {
-		return false;
+	size_t written = 0;
+	for (const InjectionStatus& entry : InjectionHistory) {
+		if (entry.Sequence <= ExportedSequence) {
+			continue;
+		}
+		file << ToJsonLine(entry) << '\n';
+		ExportedSequence = entry.Sequence;
+		++written;
 	}
 
-	SIZE_T PathBytes = strlen(DLLPath) + 1; // +1 for null terminator
-	void* RemoteBuffer = VirtualAllocEx(ProcessHandle, nullptr, PathBytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-	if (!RemoteBuffer) {
-		CloseHandle(ProcessHandle);
-		return false;
+	char message[96];
+	std::snprintf(message, sizeof(message), "Appended %zu record(s) to InjectionHistory.jsonl", written);
+	ExportMessage = message;
+}
+
+// Non-throwing parse of the PID text; 0 means empty, invalid or out of range
+ProcessID InjectorUI::ParsePID(const char* Text) {
+	ProcessID Value = 0;
+	const char* End = Text + strlen(Text);
+	auto [Last, Error] = std::from_chars(Text, End, Value);
+	if (Error != std::errc() || Last != End) {
+		return 0;
 	}
+	return Value;
+}
 
-	if (!WriteProcessMemory(ProcessHandle, RemoteBuffer, DLLPath, PathBytes, nullptr)) {
-		VirtualFreeEx(ProcessHandle, RemoteBuffer, 0, MEM_RELEASE);
-		CloseHandle(ProcessHandle);
-		return false;
+// Select a PID from code, keeping the text field in sync
+void InjectorUI::SelectPID(ProcessID TargetPID) {
+	SelectedPID = TargetPID;
+	if (TargetPID == 0) {
+		PIDInputBuffer[0] = '\0';
+	} else {
+		std::snprintf(PIDInputBuffer, sizeof(PIDInputBuffer), "%u", TargetPID);
 	}
-    
-	HMODULE kernel32Handle = GetModuleHandle(TEXT("kernel32.dll"));
-    if (!kernel32Handle) {
-        VirtualFreeEx(ProcessHandle, RemoteBuffer, 0, MEM_RELEASE);
-		CloseHandle(ProcessHandle);
-        return false;
-    }
+}
 
-	FARPROC LoadLibraryAddress = GetProcAddress(kernel32Handle, "LoadLibraryA");
-    if (!LoadLibraryAddress) {
-        VirtualFreeEx(ProcessHandle, RemoteBuffer, 0, MEM_RELEASE);
-		CloseHandle(ProcessHandle);
-        return false;
-    }
+// One row of the process list; in details mode also the table cells, fetching metadata lazily
+void InjectorUI::RenderProcessRow(const ProcessColumns& Processes, size_t Row, bool IsSelected, bool WithDetails) {
+	if (WithDetails) {
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn();
+	}
+	if (ImGui::Selectable(Processes.Label(Row), IsSelected, WithDetails ? ImGuiSelectableFlags_SpanAllColumns : 0)) {
+		SelectPID(Processes.Pids[Row]);
+	}
+	if (IsSelected) {
+		ImGui::SetItemDefaultFocus();
+	}
+	if (!WithDetails) {
+		return;
+	}
 
-	HANDLE RemoteThreadHandle = CreateRemoteThread(ProcessHandle, nullptr, 0, (LPTHREAD_START_ROUTINE)LoadLibraryAddress, RemoteBuffer, 0, nullptr);
+	const std::shared_ptr<const ProcessMetadata> metadata = MetadataCache.Get(Processes.Key(Row));
+	ImGui::TableNextColumn();
+	if (!metadata) {
+		ImGui::TextDisabled("...");
+	} else if (metadata->imagePath.empty()) {
+		ImGui::TextDisabled("(access denied)");
+	} else {
+		ImGui::TextUnformatted(metadata->imagePath.c_str());
+	}
+	ImGui::TableNextColumn();
+	if (metadata && metadata->bitness != 0) {
+		ImGui::Text("%d", metadata->bitness);
+	}
+	ImGui::TableNextColumn();
+	ImGui::Text("%u", Processes.ParentPids[Row]);
+	ImGui::TableNextColumn();
+	if (metadata && metadata->sessionId != ProcessMetadata::UnknownSession) {
+		ImGui::Text("%u", metadata->sessionId);
+	}
+	ImGui::TableNextColumn();
+	if (metadata && metadata->workingSetBytes != 0) {
+		ImGui::Text("%.1f MB", static_cast<double>(metadata->workingSetBytes) / (1024.0 * 1024.0));
+	}
+}
+
+void InjectorUI::SetDLLPath(std::string Path) {
+	DLLPath = std::move(Path);
+	DLLImage = DLLImages.Get(DLLPath);
+}
 
-	bool Success = false;
-	if (RemoteThreadHandle) {
-		WaitForSingleObject(RemoteThreadHandle, INFINITE);
-        DWORD exitCode = 0;
-        // Optionally, check thread exit code for LoadLibrary success, though this is more complex
-        // GetExitCodeThread(RemoteThreadHandle, &exitCode);
-        // Success = (exitCode != 0); // If LoadLibrary returns non-NULL module handle
-        Success = true; // For simplicity, assume success if thread created and ran
-		CloseHandle(RemoteThreadHandle);
+// Path input, the non-blocking Browse button and the recent-files drop-down
+void InjectorUI::RenderDLLPathRow() {
+	std::optional<std::string> chosen;
+	{
+		std::lock_guard lock(BrowseMutex);
+		chosen.swap(BrowseResult);
+	}
+	if (chosen) {
+		BrowseOpen = false;
+		if (!chosen->empty()) {
+			RecentDLLs.Add(*chosen);
+			SetDLLPath(std::move(*chosen));
+		}
 	}
 
-	VirtualFreeEx(ProcessHandle, RemoteBuffer, 0, MEM_RELEASE);
-	CloseHandle(ProcessHandle);
-	return Success;
+	ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x * 0.7f); // Make input text wider
+	if (ImGui::InputText("DLL Path", &DLLPath)) {
+		DLLImage = DLLImages.Get(DLLPath); // A stat per edit; parsed only for new files
+	}
+	ImGui::PopItemWidth();
+	ImGui::SameLine();
+	ImGui::BeginDisabled(BrowseOpen);
+	const float recentWidth = ImGui::GetFrameHeight() + ImGui::GetStyle().ItemSpacing.x;
+	if (ImGui::Button(BrowseOpen ? "Browsing..." : "Browse", ImVec2(ImGui::GetContentRegionAvail().x - recentWidth, 0))) {
+		BrowseOpen = Host.BrowseForDLL([this](std::string path) {
+			{
+				std::lock_guard lock(BrowseMutex);
+				BrowseResult = std::move(path);
+			}
+			Host.RequestRedraw();
+		});
+	}
+	ImGui::EndDisabled();
+	ImGui::SameLine();
+	if (ImGui::BeginCombo("##RecentDLLs", nullptr, ImGuiComboFlags_NoPreview | ImGuiComboFlags_PopupAlignLeft)) {
+		const DynamicArray<std::string>& recent = RecentDLLs.Items();
+		if (recent.empty()) {
+			ImGui::TextDisabled("No recent DLLs");
+		}
+		std::string picked;
+		for (const std::string& path : recent) {
+			if (ImGui::Selectable(path.c_str(), path == DLLPath)) {
+				picked = path; // Add() below reorders the list being iterated
+			}
+		}
+		if (!recent.empty()) {
+			ImGui::Separator();
+			if (ImGui::Selectable("Clear list")) {
+				RecentDLLs.Clear();
+			}
+		}
+		ImGui::EndCombo();
+		if (!picked.empty()) {
+			RecentDLLs.Add(picked);
+			SetDLLPath(std::move(picked));
+		}
+	}
+}
+
+// Bitness of the selected process from the metadata cache, 0 while unknown
+int InjectorUI::SelectedProcessBitness() {
+	const int Row = (Snapshot && SelectedPID != 0) ? Snapshot->FindRow(SelectedPID) : -1;
+	if (Row < 0) {
+		return 0;
+	}
+	const std::shared_ptr<const ProcessMetadata> metadata = MetadataCache.Get(Snapshot->Processes.Key(Row));
+	return metadata ? metadata->bitness : 0;
+}
+
+// Problems that would make the load fail, found from the headers before any work starts
+std::string InjectorUI::CheckDLLForTarget() {
+	if (!DLLImage) {
+		return "The DLL file does not exist.";
+	}
+	if (!DLLImage->IsValid()) {
+		return "The DLL is not a valid PE image: " + DLLImage->error;
+	}
+	const int processBitness = SelectedProcessBitness();
+	if (DLLImage->bitness != 0 && processBitness != 0 && DLLImage->bitness != processBitness) {
+		return "Architecture mismatch: a " + std::to_string(DLLImage->bitness) + "-bit DLL cannot be loaded into a " +
+			std::to_string(processBitness) + "-bit process.";
+	}
+	return {};
+}
+
+// Machine, subsystem and dependencies of the chosen DLL, with a warning when it cannot load into the selected process
+void InjectorUI::RenderDLLInfo() {
+	if (DLLPath.empty()) {
+		return;
+	}
+	const ImVec4 warningColor(1.0f, 0.4f, 0.4f, 1.0f);
+	if (!DLLImage) {
+		ImGui::TextColored(warningColor, "File not found");
+		return;
+	}
+	if (!DLLImage->IsValid()) {
+		ImGui::TextColored(warningColor, "%s", DLLImage->error.c_str());
+		return;
+	}
+
+	ImGui::TextDisabled("%s %s, %s, %u exports, %zu imports", PEMachineName(DLLImage->machine),
+		DLLImage->isDll ? "DLL" : "executable", PESubsystemName(DLLImage->subsystem), DLLImage->exportedFunctionCount, DLLImage->imports.size());
+	const int processBitness = SelectedProcessBitness();
+	if (DLLImage->bitness != 0 && processBitness != 0 && DLLImage->bitness != processBitness) {
+		ImGui::TextColored(warningColor, "%d-bit DLL, %d-bit target process", DLLImage->bitness, processBitness);
+	}
+	if (!DLLImage->isDll) {
+		ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "Not marked as a DLL; its entry point will not run as DllMain");
+	}
+	if (DLLImage->isManaged) {
+		ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), ".NET assembly; LoadLibrary will not run managed code");
+	}
+
+	if (!DLLImage->imports.empty() && ImGui::TreeNode("Imports", "Imports (%zu)", DLLImage->imports.size())) {
+		for (const PEImport& import : DLLImage->imports) {
+			ImGui::BulletText("%s (%u)%s", import.moduleName.c_str(), import.functionCount, import.delayLoaded ? " delay-loaded" : "");
+		}
+		ImGui::TreePop();
+	}
+	if (!DLLImage->exportNames.empty() && ImGui::TreeNode("Exports", "Exports (%zu)", DLLImage->exportNames.size())) {
+		ImGuiListClipper clipper; // Some DLLs export thousands of names
+		clipper.Begin(static_cast<int>(DLLImage->exportNames.size()));
+		while (clipper.Step()) {
+			for (int index = clipper.DisplayStart; index < clipper.DisplayEnd; ++index) {
+				ImGui::TextUnformatted(DLLImage->exportNames[index].c_str());
+			}
+		}
+		ImGui::TreePop();
+	}
 }
 
 // Render the Injector UI
 void InjectorUI::Render() {
+	// Pick up whatever the enumeration worker published last; never blocks
+	Snapshot = Enumerator.Latest();
+	// The worker can publish several versions between two frames, so mark the first one that arrives
+	if (Snapshot && !ProcessListShown) {
+		StartupTrace::Global().MarkOnce("Process list shown");
+		ProcessListShown = true;
+	}
+	static const ProcessColumns NoProcesses;
+	const ProcessColumns& ProcessRows = Snapshot ? Snapshot->Processes : NoProcesses;
+	MetadataCache.BeginFrame();
+	if (Snapshot && Snapshot->Version != MetadataPrunedVersion) {
+		MetadataCache.Prune(*Snapshot); // Forget processes that exited
+		ModuleCache.Prune(*Snapshot);
+		MetadataPrunedVersion = Snapshot->Version;
+	}
+
 	// --- Main Injector Panel Layout ---
 	const float titleBarHeight = 30.0f; // Height of your custom TitleBarUI
 	ImVec2 mainDisplaySize = ImGui::GetIO().DisplaySize;
@@ -145,120 +441,155 @@ void InjectorUI::Render() {
 	ImGui::Begin("InjectorPanel", nullptr, window_flags);
 
 	// --- UI Elements ---
-	ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x * 0.7f); // Make input text wider
-	ImGui::InputText("DLL Path", DLLPathBuffer, IM_ARRAYSIZE(DLLPathBuffer));
+	RenderDLLPathRow();
+	RenderDLLInfo();
+
+	ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x * 0.7f);
+	if (ImGui::InputText("Target PID", PIDInputBuffer, IM_ARRAYSIZE(PIDInputBuffer), ImGuiInputTextFlags_CharsDecimal)) {
+		SelectedPID = ParsePID(PIDInputBuffer); // Parsed only when the text actually changes
+	}
 	ImGui::PopItemWidth();
 	ImGui::SameLine();
-	if (ImGui::Button("Browse", ImVec2(ImGui::GetContentRegionAvail().x, 0))) { // Fill remaining width
-		FileDialog::SelectDLL(OwnerHWND, DLLPathBuffer, IM_ARRAYSIZE(DLLPathBuffer));
+	if (ImGui::Button("Refresh", ImVec2(ImGui::GetContentRegionAvail().x, 0))) { // Fill remaining width
+		Enumerator.RequestRefresh();
+		SelectPID(0); // Clear selected PID on refresh
 	}
 
 	ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x * 0.7f);
-	ImGui::InputText("Target PID", PIDInputBuffer, IM_ARRAYSIZE(PIDInputBuffer));
+	if (ImGui::SliderInt("Auto-refresh", &AutoRefreshSeconds, 0, 30, AutoRefreshSeconds == 0 ? "Off" : "%d s")) {
+		Enumerator.SetAutoRefreshInterval(std::chrono::seconds(AutoRefreshSeconds));
+	}
 	ImGui::PopItemWidth();
-	ImGui::SameLine();
-	if (ImGui::Button("Refresh", ImVec2(ImGui::GetContentRegionAvail().x, 0))) { // Fill remaining width
-		RefreshProcessIDList();
-		PIDInputBuffer[0] = '\0'; // Clear selected PID on refresh
+	if (const char* LiveSource = Enumerator.LiveUpdateSource()) {
+		ImGui::SameLine();
+		ImGui::TextDisabled("Live (%s)", LiveSource); // Starts and exits arrive as events; auto-refresh is only a backstop
 	}
 
     // --- Process List Combo Box ---
-    char comboPreviewText[MAX_PATH + 30] = "Select Process..."; // Buffer for "Name (PID)" or PID
-    if (PIDInputBuffer[0] != '\0') {
-        DWORD currentPid = 0;
-        try {
-            currentPid = std::stoul(PIDInputBuffer); // Convert string PID to DWORD
-        } catch (const std::exception&) {
-            // PIDInputBuffer is not a valid number, keep "Select Process..." or clear
-            PIDInputBuffer[0] = '\0'; // Clear invalid PID
-        }
-
-        if (currentPid != 0) {
-            bool found = false;
-            for (const auto& procInfo : ProcessInfoList) {
-                if (procInfo.pid == currentPid) {
-                    char nameNarrow[MAX_PATH];
-                    WideCharToMultiByte(CP_UTF8, 0, procInfo.processName.c_str(), -1, nameNarrow, MAX_PATH, nullptr, nullptr);
-                    sprintf_s(comboPreviewText, sizeof(comboPreviewText), "%s (%lu)", nameNarrow, procInfo.pid);
-                    found = true;
-                    break;
-                }
-            }
-            if (!found) { // PID is a number but not in the current list, show the PID itself
-                sprintf_s(comboPreviewText, sizeof(comboPreviewText), "%s", PIDInputBuffer);
-            }
-        }
+    char comboPreviewBuffer[32] = "Select Process...";
+    const char* comboPreviewText = Snapshot ? comboPreviewBuffer : "Loading processes...";
+    const int selectedRow = (Snapshot && SelectedPID != 0) ? Snapshot->FindRow(SelectedPID) : -1;
+    if (selectedRow >= 0) {
+        comboPreviewText = ProcessRows.Label(selectedRow);
+    } else if (SelectedPID != 0) { // PID is a number but not in the current list, show the PID itself
+        std::snprintf(comboPreviewBuffer, sizeof(comboPreviewBuffer), "%u", SelectedPID);
+        comboPreviewText = comboPreviewBuffer;
     }
 
 	if (ImGui::BeginCombo("##PIDCombo", comboPreviewText, ImGuiComboFlags_HeightLargest)) {
-		for (const auto& procInfo : ProcessInfoList) {
-			char nameNarrow[MAX_PATH];
-			// Convert WCHAR process name to char for ImGui display
-			WideCharToMultiByte(CP_UTF8, 0, procInfo.processName.c_str(), -1, nameNarrow, MAX_PATH, nullptr, nullptr);
-			
-			char itemLabel[MAX_PATH + 30]; // For "Process Name (PID)"
-			sprintf_s(itemLabel, sizeof(itemLabel), "%s (%lu)", nameNarrow, procInfo.pid);
-
-			bool is_selected = false;
-            if (PIDInputBuffer[0] != '\0') {
-                 try {
-                    is_selected = (procInfo.pid == std::stoul(PIDInputBuffer));
-                } catch (const std::exception&) { /* ignore, PIDInputBuffer might be temporarily non-numeric */ }
-            }
-
-			if (ImGui::Selectable(itemLabel, is_selected)) {
-				sprintf_s(PIDInputBuffer, sizeof(PIDInputBuffer), "%lu", procInfo.pid);
+		ImGui::Checkbox("Details", &ShowProcessDetails);
+		ImGui::SameLine();
+		if (ImGui::IsWindowAppearing()) {
+			ImGui::SetKeyboardFocusHere();
+		}
+		ImGui::SetNextItemWidth(-FLT_MIN);
+		ImGui::InputTextWithHint("##ProcessFilter", "Type to filter...", ProcessFilterBuffer, IM_ARRAYSIZE(ProcessFilterBuffer));
+		if (Snapshot) {
+			Filter.Update(Snapshot->SearchIndex, Snapshot->Version, ProcessFilterBuffer); // No-op unless the text or snapshot changed
+		}
+		static const std::vector<uint32_t> NoRows;
+		const std::vector<uint32_t>& visibleRows = Snapshot ? Filter.MatchingRows() : NoRows;
+
+		// A short filtered list is fetched up front so its details are ready as soon as it scrolls into view
+		constexpr size_t MetadataPrefetchLimit = 64;
+		if (ShowProcessDetails && Filter.IsFiltering() && visibleRows.size() <= MetadataPrefetchLimit) {
+			for (uint32_t row : visibleRows) {
+				MetadataCache.Get(ProcessRows.Key(row));
 			}
-			if (is_selected) {
-				ImGui::SetItemDefaultFocus();
+		}
+
+		const ImGuiTableFlags detailsFlags = ImGuiTableFlags_Resizable | ImGuiTableFlags_Hideable | ImGuiTableFlags_RowBg |
+			ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_NoSavedSettings;
+		const bool detailsTable = ShowProcessDetails && ImGui::BeginTable("##ProcessDetails", 6, detailsFlags);
+		if (detailsTable) {
+			ImGui::TableSetupColumn("Process", ImGuiTableColumnFlags_NoHide);
+			ImGui::TableSetupColumn("Image Path", ImGuiTableColumnFlags_WidthStretch);
+			ImGui::TableSetupColumn("Bits");
+			ImGui::TableSetupColumn("Parent");
+			ImGui::TableSetupColumn("Session");
+			ImGui::TableSetupColumn("Working Set");
+			ImGui::TableHeadersRow();
+		}
+
+		// Only the visible rows are submitted; labels were built when the snapshot was taken
+		ImGuiListClipper clipper;
+		clipper.Begin(static_cast<int>(visibleRows.size()));
+		if (selectedRow >= 0) {
+			// Rows are ascending, so the selected row's position in the filtered list is a binary search away
+			auto selectedPosition = std::lower_bound(visibleRows.begin(), visibleRows.end(), static_cast<uint32_t>(selectedRow));
+			if (selectedPosition != visibleRows.end() && *selectedPosition == static_cast<uint32_t>(selectedRow)) {
+				clipper.IncludeItemByIndex(static_cast<int>(selectedPosition - visibleRows.begin())); // Keep the default-focus row alive when the combo opens
+			}
+		}
+		while (clipper.Step()) {
+			for (int position = clipper.DisplayStart; position < clipper.DisplayEnd; ++position) {
+				const int row = static_cast<int>(visibleRows[position]);
+				RenderProcessRow(ProcessRows, row, row == selectedRow, detailsTable);
 			}
 		}
+		if (detailsTable) {
+			ImGui::EndTable();
+		}
 		ImGui::EndCombo();
 	}
 
-	// --- Inject Button and Modal ---
+	// --- Inject Button and Status Panel ---
+	ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x * 0.7f);
+	ImGui::SliderInt("Timeout", &InjectionTimeoutSeconds, 1, 120, "%d s");
+	ImGui::PopItemWidth();
+
+	const InjectionStatus status = Injector.Status();
+	const bool running = status.State == InjectionState::Running;
+	if (!running && status.State != InjectionState::Idle && status.Sequence != RecordedSequence) {
+		constexpr size_t MaxHistory = 200;
+		if (InjectionHistory.size() == MaxHistory) {
+			InjectionHistory.erase(InjectionHistory.begin());
+		}
+		InjectionHistory.push_back(status);
+		RecordedSequence = status.Sequence;
+		// Re-read the target's modules so the panel shows whether the DLL is really loaded
+		const int targetRow = Snapshot ? Snapshot->FindRow(status.TargetPID) : -1;
+		if (targetRow >= 0) {
+			ModuleCache.Refresh(ProcessRows.Key(targetRow));
+		}
+	}
+	ImGui::BeginDisabled(running);
 	if (ImGui::Button("Inject DLL", ImVec2(ImGui::GetContentRegionAvail().x, 25))) { // Wider button
-		DWORD targetPID = 0;
-        if (PIDInputBuffer[0] != '\0') {
-            try {
-                targetPID = std::stoul(PIDInputBuffer);
-            } catch (const std::exception&) {
-                targetPID = 0; // Invalid PID entered
-            }
-        }
-
-		if (targetPID != 0 && DLLPathBuffer[0] != '\0') {
-			bool success = InjectUsingRemoteThread(DLLPathBuffer, targetPID);
-			ImGui::OpenPopup(success ? "Injection Succeeded" : "Injection Failed");
+		const ProcessID targetPID = SelectedPID;
+		if (targetPID != 0 && !DLLPath.empty()) {
+			DLLImage = DLLImages.Get(DLLPath); // Picks up a DLL rebuilt since it was chosen
+			InvalidInputMessage = CheckDLLForTarget();
+			if (InvalidInputMessage.empty()) {
+				Injector.Start(DLLPath, targetPID, static_cast<std::uint32_t>(InjectionTimeoutSeconds) * 1000);
+				RecentDLLs.Add(DLLPath);
+			}
 		} else {
-            ImGui::OpenPopup("Invalid Input");
-        }
-	}
-
-    // Success Modal
-	if (ImGui::BeginPopupModal("Injection Succeeded", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
-		ImGui::Text("DLL Injected Successfully!");
-		ImGui::Separator();
-		if (ImGui::Button("OK", ImVec2(120, 0))) { ImGui::CloseCurrentPopup(); }
-		ImGui::EndPopup();
-	}
-
-    // Failure Modal
-	if (ImGui::BeginPopupModal("Injection Failed!!", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
-		ImGui::Text("DLL injection failed.");
-        ImGui::Text("Possible reasons:\n- Incorrect PID\n- DLL path error\n- Insufficient permissions\n- Target process architecture mismatch (32/64-bit)\n- Security software interference");
-		ImGui::Separator();
-		if (ImGui::Button("OK", ImVec2(120, 0))) { ImGui::CloseCurrentPopup(); }
-		ImGui::EndPopup();
-	}
-    
-    // Invalid Input Modal
-    if (ImGui::BeginPopupModal("Invalid Input", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
-		ImGui::Text("Please ensure DLL path and Target PID are valid.");
-		ImGui::Separator();
-		if (ImGui::Button("OK", ImVec2(120, 0))) { ImGui::CloseCurrentPopup(); }
-		ImGui::EndPopup();
+			InvalidInputMessage = "Please ensure DLL path and Target PID are valid.";
+		}
 	}
+	ImGui::EndDisabled();
+
+	ImGui::Separator();
+	if (running) {
+		const float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - status.StartTime).count();
+		ImGui::Text("Injecting into PID %u... %.1f s", status.TargetPID, elapsed);
+		ImGui::ProgressBar(-1.0f * static_cast<float>(ImGui::GetTime()), ImVec2(ImGui::GetContentRegionAvail().x * 0.7f, 0), "Waiting for remote thread");
+		ImGui::SameLine();
+		if (ImGui::Button("Cancel", ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
+			Injector.Cancel();
+		}
+	} else if (!InvalidInputMessage.empty()) {
+		ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "%s", InvalidInputMessage.c_str());
+	} else if (status.State != InjectionState::Idle) {
+		const bool succeeded = status.State == InjectionState::Succeeded;
+		const float duration = std::chrono::duration<float>(status.EndTime - status.StartTime).count();
+		ImGui::TextColored(succeeded ? ImVec4(0.4f, 0.9f, 0.4f, 1.0f) : ImVec4(1.0f, 0.4f, 0.4f, 1.0f),
+			"%s (PID %u, %.2f s)", succeeded ? "Injection succeeded" : "Injection failed", status.TargetPID, duration);
+		ImGui::TextWrapped("%s", status.Message.c_str());
+	}
+
+	RenderModules();
+	RenderHistory();
 
 	ImGui::End(); // End of "InjectorPanel"
 }
\ No newline at end of file
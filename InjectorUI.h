@@ -1,34 +1,67 @@
 #pragma once
 #include <imgui.h>
-#include <Windows.h>
-#include <vector>
-#include <string> // Required for std::wstring
-
-extern IMGUI_IMPL_API LRESULT
-	ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
-
-template<typename T>
-using DynamicArray = std::vector<T>;
-
-// Structure to hold process information
-struct ProcessInfo {
-	DWORD pid;
-	std::wstring processName; // Using wstring to correctly store TCHAR/WCHAR names
-};
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include "ProcessEnumerator.h"
+#include "ProcessMetadataCache.h"
+#include "ProcessModuleCache.h"
+#include "InjectionWorker.h"
+#include "PEImage.h"
+#include "RecentFileList.h"
+#include "UIHost.h"
 
 struct InjectorUI {
 private:
-	HWND OwnerHWND;
-	char DLLPathBuffer[256];
+	UIHost& Host;
+	std::string DLLPath;                               // UTF-8, any length
+	PEImageCache DLLImages;                            // Parsed DLL headers, re-validated by size and mtime
+	std::shared_ptr<const PEImageInfo> DLLImage;      // DLLPath's image, null when the file is missing
+	RecentFileList RecentDLLs;                         // Read from disk the first time the list is opened
+	bool BrowseOpen = false;                           // A file picker is open; its result arrives in BrowseResult
+	std::mutex BrowseMutex;
+	std::optional<std::string> BrowseResult;           // Posted by the picker thread, empty string = cancelled
 	char PIDInputBuffer[16];          // Stores the selected PID as a string
-	DynamicArray<ProcessInfo> ProcessInfoList; // Stores list of processes with names and PIDs
+	ProcessID SelectedPID = 0;            // PIDInputBuffer parsed on edit, 0 when empty or invalid
+	ProcessEnumerator Enumerator;                      // Enumerates processes off the render thread
+	std::shared_ptr<const ProcessSnapshot> Snapshot;    // Latest list picked up by Render(), null while loading
+	bool ProcessListShown = false;                      // The first snapshot has been drawn and traced
+	int AutoRefreshSeconds = 0;                         // 0 = only refresh on demand
+	char ProcessFilterBuffer[64];                       // Type-to-filter text shown above the process list
+	ProcessFilter Filter;
+	ProcessMetadataCache MetadataCache;                 // Path, bitness, session and working set per visible row
+	ProcessModuleCache ModuleCache;                     // Loaded modules of the selected process, while the panel is open
+	unsigned long long MetadataPrunedVersion = 0;       // Snapshot version the caches were last pruned against
+	bool ShowProcessDetails = false;                    // Draw the process list as a table with metadata columns
+	InjectionWorker Injector;                           // Runs the load off the render thread
+	int InjectionTimeoutSeconds = 10;                   // How long to wait for the remote thread
+	std::string InvalidInputMessage;                    // Why the last Inject click did not start, empty otherwise
+	DynamicArray<InjectionStatus> InjectionHistory;     // Finished operations, oldest first
+	unsigned long long RecordedSequence = 0;            // Last operation added to InjectionHistory
+	unsigned long long ExportedSequence = 0;            // Last operation written by ExportHistory
+	std::string ExportMessage;
 
-	static static bool InjectUsingRemoteThread(const char* DLLPath, DWORD TargetProcessID);
-	void RefreshProcessIDList();
+	static ProcessID ParsePID(const char* Text);
+	void SelectPID(ProcessID TargetPID);
+	void SetDLLPath(std::string Path);
+	void RenderDLLPathRow();
+	int SelectedProcessBitness();
+	std::string CheckDLLForTarget();
+	void RenderDLLInfo();
+	void RenderProcessRow(const ProcessColumns& Processes, size_t Row, bool IsSelected, bool WithDetails);
+	void RenderModules();
+	void RenderHistory();
+	void ExportHistory();
 
 public:
-	explicit InjectorUI(HWND OwnerHWND);
+	// The sources and backend are injected so the headless harness can run the panel on synthetic data
+	InjectorUI(UIHost& Host, std::unique_ptr<ProcessSource> EnumerationSource, std::unique_ptr<ProcessSource> MetadataSource,
+		std::unique_ptr<ProcessSource> ModuleSource, std::unique_ptr<InjectionBackend> Injection);
 	~InjectorUI();
 
+	// Starts process enumeration; called once the first frame is on screen
+	void StartBackgroundWork();
 	void Render();
+	bool IsAnimating() const;
 };
\ No newline at end of file
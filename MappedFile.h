@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// Read-only view of a whole file. Empty when the file could not be opened or mapped, or is empty.
+// Reading the view faults if another process truncates the file meanwhile, so keep it short-lived.
+struct MappedFile {
+private:
+	const std::uint8_t* View = nullptr;
+	size_t Length = 0;
+
+public:
+	explicit MappedFile(const std::filesystem::path& Path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool IsOpen() const { return View != nullptr; }
+	const std::uint8_t* Data() const { return View; }
+	size_t Size() const { return Length; }
+};
@@ -0,0 +1,27 @@
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::filesystem::path& Path) {
+	const int Descriptor = open(Path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (Descriptor < 0) {
+		return;
+	}
+	struct stat Status;
+	if (fstat(Descriptor, &Status) == 0 && S_ISREG(Status.st_mode) && Status.st_size > 0) {
+		void* Mapping = mmap(nullptr, static_cast<size_t>(Status.st_size), PROT_READ, MAP_PRIVATE, Descriptor, 0);
+		if (Mapping != MAP_FAILED) {
+			View = static_cast<const std::uint8_t*>(Mapping);
+			Length = static_cast<size_t>(Status.st_size);
+		}
+	}
+	close(Descriptor); // The mapping keeps the file alive
+}
+
+MappedFile::~MappedFile() {
+	if (View) {
+		munmap(const_cast<std::uint8_t*>(View), Length);
+	}
+}
@@ -0,0 +1,32 @@
+#include "MappedFile.h"
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+
+MappedFile::MappedFile(const std::filesystem::path& Path) {
+	// FILE_SHARE_DELETE so a build can still replace the DLL while it is mapped here
+	HANDLE File = CreateFileW(Path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (File == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	LARGE_INTEGER FileSize = {};
+	if (GetFileSizeEx(File, &FileSize) && FileSize.QuadPart > 0 && static_cast<unsigned long long>(FileSize.QuadPart) <= SIZE_MAX) {
+		HANDLE Mapping = CreateFileMappingW(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (Mapping) {
+			View = static_cast<const std::uint8_t*>(MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0));
+			if (View) {
+				Length = static_cast<size_t>(FileSize.QuadPart);
+			}
+			CloseHandle(Mapping); // The view keeps the mapping alive
+		}
+	}
+	CloseHandle(File);
+}
+
+MappedFile::~MappedFile() {
+	if (View) {
+		UnmapViewOfFile(View);
+	}
+}
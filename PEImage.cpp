@@ -0,0 +1,304 @@
+#include "PEImage.h"
+#include "MappedFile.h"
+#include "TextConversion.h"
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+
+namespace {
+
+// IMAGE_DIRECTORY_ENTRY_* indices used here
+constexpr std::uint32_t ExportDirectory = 0;
+constexpr std::uint32_t ImportDirectory = 1;
+constexpr std::uint32_t DelayImportDirectory = 13;
+constexpr std::uint32_t ClrDirectory = 14;
+
+// Caps that keep a corrupt table from turning into millions of allocations
+constexpr std::uint32_t MaxExports = 1u << 16;
+constexpr std::uint32_t MaxImportModules = 4096;
+constexpr std::uint32_t MaxImportFunctions = 1u << 16;
+constexpr size_t MaxNameLength = 4096;
+
+struct Section {
+	std::uint32_t VirtualAddress, VirtualSize, RawOffset, RawSize;
+};
+
+// Little-endian, bounds-checked reads over the mapped file
+struct ImageReader {
+	const std::uint8_t* Data;
+	size_t Size;
+	DynamicArray<Section> Sections;
+	std::uint32_t HeadersSize = 0;
+
+	template <typename T>
+	bool Read(size_t Offset, T& Out) const {
+		if (Offset > Size || Size - Offset < sizeof(T)) {
+			return false;
+		}
+		std::memcpy(&Out, Data + Offset, sizeof(T)); // PE is little-endian, like every target this builds for
+		return true;
+	}
+
+	// File offset of an RVA, or false when it is not backed by file data
+	bool OffsetOf(std::uint32_t Rva, size_t& Out) const {
+		if (Rva < HeadersSize) {
+			Out = Rva;
+			return Rva < Size;
+		}
+		for (const Section& Candidate : Sections) {
+			if (Rva >= Candidate.VirtualAddress && Rva - Candidate.VirtualAddress < Candidate.RawSize) {
+				Out = static_cast<size_t>(Candidate.RawOffset) + (Rva - Candidate.VirtualAddress);
+				return Out < Size;
+			}
+		}
+		return false;
+	}
+
+	template <typename T>
+	bool ReadRva(std::uint32_t Rva, T& Out) const {
+		size_t Offset;
+		return OffsetOf(Rva, Offset) && Read(Offset, Out);
+	}
+
+	// A NUL-terminated ASCII name at an RVA
+	bool ReadName(std::uint32_t Rva, std::string_view& Out) const {
+		size_t Offset;
+		if (!OffsetOf(Rva, Offset)) {
+			return false;
+		}
+		const size_t Limit = std::min(Size - Offset, MaxNameLength);
+		const void* Terminator = std::memchr(Data + Offset, '\0', Limit);
+		if (!Terminator) {
+			return false;
+		}
+		Out = std::string_view(reinterpret_cast<const char*>(Data + Offset), static_cast<const std::uint8_t*>(Terminator) - (Data + Offset));
+		return true;
+	}
+};
+
+struct DataDirectoryEntry {
+	std::uint32_t Rva = 0, Size = 0;
+};
+
+void ParseExports(const ImageReader& Reader, const DataDirectoryEntry& Directory, PEImageInfo& Info) {
+	std::uint32_t FunctionCount = 0, NameCount = 0, NamesRva = 0;
+	if (!Reader.ReadRva(Directory.Rva + 20, FunctionCount) || !Reader.ReadRva(Directory.Rva + 24, NameCount) ||
+		!Reader.ReadRva(Directory.Rva + 32, NamesRva)) {
+		return;
+	}
+	Info.exportedFunctionCount = FunctionCount;
+	NameCount = std::min(NameCount, MaxExports);
+	Info.exportNames.reserve(NameCount);
+	for (std::uint32_t Index = 0; Index < NameCount; ++Index) {
+		std::uint32_t NameRva = 0;
+		std::string_view Name;
+		if (!Reader.ReadRva(NamesRva + Index * 4, NameRva) || !Reader.ReadName(NameRva, Name)) {
+			break;
+		}
+		Info.exportNames.emplace_back(Name);
+	}
+}
+
+// Counts the entries of an import lookup table, which ends with a zero thunk
+std::uint32_t CountThunks(const ImageReader& Reader, std::uint32_t TableRva, bool Is64Bit) {
+	std::uint32_t Count = 0;
+	for (; Count < MaxImportFunctions; ++Count) {
+		std::uint64_t Thunk = 0;
+		bool Read;
+		if (Is64Bit) {
+			Read = Reader.ReadRva(TableRva + Count * 8, Thunk);
+		} else {
+			std::uint32_t Thunk32 = 0;
+			Read = Reader.ReadRva(TableRva + Count * 4, Thunk32);
+			Thunk = Thunk32;
+		}
+		if (!Read || Thunk == 0) {
+			break;
+		}
+	}
+	return Count;
+}
+
+// IMAGE_IMPORT_DESCRIPTOR (20 bytes) and IMAGE_DELAYLOAD_DESCRIPTOR (32 bytes) arrays end with a zeroed entry
+void ParseImports(const ImageReader& Reader, const DataDirectoryEntry& Directory, bool Delayed, bool Is64Bit, PEImageInfo& Info) {
+	const std::uint32_t DescriptorSize = Delayed ? 32 : 20;
+	const std::uint32_t NameField = Delayed ? 4 : 12;
+	for (std::uint32_t Index = 0; Index < MaxImportModules; ++Index) {
+		const std::uint32_t Descriptor = Directory.Rva + Index * DescriptorSize;
+		std::uint32_t NameRva = 0, LookupRva = 0, AddressRva = 0;
+		if (!Reader.ReadRva(Descriptor + NameField, NameRva) || NameRva == 0) {
+			break;
+		}
+		if (Delayed) {
+			Reader.ReadRva(Descriptor + 16, LookupRva); // ImportNameTableRVA
+		} else {
+			Reader.ReadRva(Descriptor, LookupRva);          // OriginalFirstThunk
+			Reader.ReadRva(Descriptor + 16, AddressRva);    // FirstThunk, for binders that omit the lookup table
+		}
+
+		std::string_view Name;
+		if (!Reader.ReadName(NameRva, Name)) {
+			break;
+		}
+		PEImport Import;
+		Import.moduleName = Name;
+		Import.functionCount = CountThunks(Reader, LookupRva != 0 ? LookupRva : AddressRva, Is64Bit);
+		Import.delayLoaded = Delayed;
+		Info.imports.push_back(std::move(Import));
+	}
+}
+
+} // namespace
+
+const char* PEMachineName(std::uint16_t Machine) {
+	switch (Machine) {
+		case 0x014C: return "x86";
+		case 0x8664: return "x64";
+		case 0xAA64: return "ARM64";
+		case 0x01C4: return "ARM";
+		default: return "unknown machine";
+	}
+}
+
+const char* PESubsystemName(std::uint16_t Subsystem) {
+	switch (Subsystem) {
+		case 1: return "native";
+		case 2: return "Windows GUI";
+		case 3: return "Windows console";
+		case 10: return "EFI application";
+		default: return "other subsystem";
+	}
+}
+
+PEImageInfo ParsePEImage(const std::uint8_t* Data, size_t Size) {
+	PEImageInfo Info;
+	ImageReader Reader = { Data, Size, {} };
+
+	std::uint16_t DosMagic = 0;
+	std::uint32_t NtHeadersOffset = 0;
+	if (!Reader.Read(0, DosMagic) || DosMagic != 0x5A4D || !Reader.Read(0x3C, NtHeadersOffset)) {
+		Info.error = "Not a PE image (no MZ header)";
+		return Info;
+	}
+	std::uint32_t Signature = 0;
+	if (!Reader.Read(NtHeadersOffset, Signature) || Signature != 0x00004550) {
+		Info.error = "Not a PE image (no PE signature)";
+		return Info;
+	}
+
+	// IMAGE_FILE_HEADER
+	const size_t FileHeader = static_cast<size_t>(NtHeadersOffset) + 4;
+	std::uint16_t SectionCount = 0, OptionalHeaderSize = 0, Characteristics = 0;
+	if (!Reader.Read(FileHeader, Info.machine) || !Reader.Read(FileHeader + 2, SectionCount) ||
+		!Reader.Read(FileHeader + 16, OptionalHeaderSize) || !Reader.Read(FileHeader + 18, Characteristics)) {
+		Info.error = "Truncated file header";
+		return Info;
+	}
+	Info.isDll = (Characteristics & 0x2000) != 0; // IMAGE_FILE_DLL
+
+	// IMAGE_OPTIONAL_HEADER32/64 share the fields up to the data directories, at different offsets after ImageBase
+	const size_t OptionalHeader = FileHeader + 20;
+	std::uint16_t Magic = 0;
+	if (!Reader.Read(OptionalHeader, Magic) || (Magic != 0x10B && Magic != 0x20B)) {
+		Info.error = "Unknown optional header";
+		return Info;
+	}
+	const bool Is64Bit = Magic == 0x20B;
+	const size_t DirectoryCountOffset = OptionalHeader + (Is64Bit ? 108 : 92);
+	std::uint32_t DirectoryCount = 0;
+	if (!Reader.Read(OptionalHeader + 60, Reader.HeadersSize) || !Reader.Read(OptionalHeader + 68, Info.subsystem) ||
+		!Reader.Read(DirectoryCountOffset, DirectoryCount)) {
+		Info.error = "Truncated optional header";
+		return Info;
+	}
+	switch (Info.machine) {
+		case 0x014C: case 0x01C4: Info.bitness = 32; break;
+		case 0x8664: case 0xAA64: Info.bitness = 64; break;
+		default: Info.bitness = 0; break;
+	}
+	if (Info.bitness != 0 && Info.bitness != (Is64Bit ? 64 : 32)) {
+		Info.error = "Machine type does not match the optional header";
+		return Info;
+	}
+
+	// Only the first 24 bytes of each 40-byte header are read, but the loader needs the whole table
+	const size_t SectionTable = OptionalHeader + OptionalHeaderSize;
+	if (SectionTable + static_cast<size_t>(SectionCount) * 40 > Size) {
+		Info.error = "Truncated section table";
+		return Info;
+	}
+	Reader.Sections.reserve(SectionCount);
+	for (std::uint16_t Index = 0; Index < SectionCount; ++Index) {
+		const size_t Header = SectionTable + static_cast<size_t>(Index) * 40;
+		Section Entry = {};
+		if (!Reader.Read(Header + 8, Entry.VirtualSize) || !Reader.Read(Header + 12, Entry.VirtualAddress) ||
+			!Reader.Read(Header + 16, Entry.RawSize) || !Reader.Read(Header + 20, Entry.RawOffset)) {
+			Info.error = "Truncated section table";
+			return Info;
+		}
+		Entry.RawSize = std::min(Entry.RawSize, Entry.VirtualSize != 0 ? Entry.VirtualSize : Entry.RawSize);
+		Reader.Sections.push_back(Entry);
+	}
+
+	const auto ReadDirectory = [&](std::uint32_t Index) {
+		DataDirectoryEntry Directory;
+		if (Index < DirectoryCount) {
+			const size_t Offset = DirectoryCountOffset + 4 + static_cast<size_t>(Index) * 8;
+			Reader.Read(Offset, Directory.Rva);
+			Reader.Read(Offset + 4, Directory.Size);
+		}
+		return Directory;
+	};
+	if (const DataDirectoryEntry Exports = ReadDirectory(ExportDirectory); Exports.Rva != 0) {
+		ParseExports(Reader, Exports, Info);
+	}
+	if (const DataDirectoryEntry Imports = ReadDirectory(ImportDirectory); Imports.Rva != 0) {
+		ParseImports(Reader, Imports, false, Is64Bit, Info);
+	}
+	if (const DataDirectoryEntry DelayImports = ReadDirectory(DelayImportDirectory); DelayImports.Rva != 0) {
+		ParseImports(Reader, DelayImports, true, Is64Bit, Info);
+	}
+	Info.isManaged = ReadDirectory(ClrDirectory).Rva != 0;
+	return Info;
+}
+
+PEImageInfo ParsePEFile(const std::filesystem::path& Path) {
+	const MappedFile File(Path);
+	if (!File.IsOpen()) {
+		std::error_code Error;
+		PEImageInfo Info;
+		Info.error = std::filesystem::file_size(Path, Error) == 0 && !Error ? "The file is empty" : "Cannot open or map the file";
+		return Info;
+	}
+	return ParsePEImage(File.Data(), File.Size());
+}
+
+std::shared_ptr<const PEImageInfo> PEImageCache::Get(std::string_view Utf8Path) {
+#ifdef _WIN32
+	const std::filesystem::path Path(WideFromUtf8(Utf8Path));
+#else
+	const std::filesystem::path Path(Utf8Path);
+#endif
+	// file_size also fails for directories and other non-regular files, so it doubles as the type check
+	std::error_code Error;
+	const std::uintmax_t Size = Utf8Path.empty() ? 0 : std::filesystem::file_size(Path, Error);
+	if (Utf8Path.empty() || Error) {
+		return nullptr;
+	}
+	const std::filesystem::file_time_type Modified = std::filesystem::last_write_time(Path, Error);
+	if (Error) {
+		return nullptr;
+	}
+
+	auto Found = Entries.find(Path.native());
+	if (Found != Entries.end() && Found->second.Size == Size && Found->second.Modified == Modified) {
+		return Found->second.Image;
+	}
+	constexpr size_t MaxEntries = 64; // Paths typed one character at a time are mostly misses
+	if (Found == Entries.end() && Entries.size() >= MaxEntries) {
+		Entries.clear();
+	}
+	auto Image = std::make_shared<const PEImageInfo>(ParsePEFile(Path));
+	Entries[Path.native()] = { Size, Modified, Image };
+	return Image;
+}
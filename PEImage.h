@@ -0,0 +1,78 @@
+#pragma once
+#include "ProcessInfo.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// One imported module and how many functions are taken from it
+struct PEImport {
+	std::string moduleName;
+	std::uint32_t functionCount = 0;
+	bool delayLoaded = false;
+};
+
+// What the injector needs to know about a DLL before trying to load it
+struct PEImageInfo {
+	std::string error;             // Empty when the headers parsed; otherwise why the file is not a usable image
+	std::uint16_t machine = 0;     // IMAGE_FILE_MACHINE_*
+	int bitness = 0;               // 32 or 64, 0 for machines the injector does not know
+	std::uint16_t subsystem = 0;   // IMAGE_SUBSYSTEM_*
+	bool isDll = false;
+	bool isManaged = false;        // Has a CLR header; LoadLibrary will not run managed code
+	std::uint32_t exportedFunctionCount = 0; // Including exports by ordinal only
+	DynamicArray<std::string> exportNames;   // In the export table's (sorted) order
+	DynamicArray<PEImport> imports;
+
+	bool IsValid() const { return error.empty(); }
+};
+
+const char* PEMachineName(std::uint16_t Machine);
+const char* PESubsystemName(std::uint16_t Subsystem);
+
+// Decodes the headers, export and import tables of an image in memory. Every read is bounds-checked,
+// so a truncated or hostile file yields an error rather than a crash.
+PEImageInfo ParsePEImage(const std::uint8_t* Data, size_t Size);
+// Memory-maps the file and parses it
+PEImageInfo ParsePEFile(const std::filesystem::path& Path);
+
+// Parsed images keyed by path and validated against the file's size and modification time,
+// so re-checking an unchanged DLL costs two stats and no reads. Render thread only.
+struct PEImageCache {
+private:
+	struct Entry {
+		std::uintmax_t Size;
+		std::filesystem::file_time_type Modified;
+		std::shared_ptr<const PEImageInfo> Image;
+	};
+
+	std::unordered_map<std::filesystem::path::string_type, Entry> Entries;
+
+public:
+	// Null when the file does not exist or cannot be examined
+	std::shared_ptr<const PEImageInfo> Get(std::string_view Utf8Path);
+};
+
+// Shape of an image built by MakeSyntheticPEImage
+struct SyntheticPEOptions {
+	bool is64Bit = true;                  // PE32+ x64, otherwise PE32 x86
+	std::uint32_t exportCount = 16;       // Named Export_<n>
+	std::uint32_t importModules = 4;      // module_<n>.dll
+	std::uint32_t delayImportModules = 0; // delayed_<n>.dll
+	std::uint32_t functionsPerModule = 8; // Imported by ordinal
+};
+
+// A synthetic image and the file offsets of the fields tests corrupt
+struct SyntheticPEImage {
+	DynamicArray<std::uint8_t> bytes;
+	size_t machineOffset = 0;         // IMAGE_FILE_HEADER.Machine
+	size_t sectionTableEnd = 0;       // Everything before this is needed to parse any table
+	size_t exportDirectoryOffset = 0; // IMAGE_EXPORT_DIRECTORY
+	size_t firstExportNameOffset = 0; // Export names are back to back from here
+};
+
+// A minimal well-formed DLL, so benchmarks and parser tests do not need a corpus of Windows binaries
+SyntheticPEImage MakeSyntheticPEImage(const SyntheticPEOptions& Options);
@@ -0,0 +1,36 @@
+#include "ProcStat.h"
+#include <charconv>
+#include <cstring>
+
+// /proc/<pid>/stat is "pid (comm) state ppid ..." with one space between fields.
+// comm may itself contain spaces and parentheses, so it ends at the last ')'.
+bool ParseStat(std::string_view Stat, ProcStat& Out) {
+	const size_t Open = Stat.find('(');
+	const size_t Close = Stat.rfind(')');
+	if (Open == std::string_view::npos || Close == std::string_view::npos || Close < Open) {
+		return false;
+	}
+	Out.name = Stat.substr(Open + 1, Close - Open - 1);
+
+	// Fields after ") " start at 3 (state)
+	const char* Cursor = Stat.data() + Close + 2;
+	const char* End = Stat.data() + Stat.size();
+	for (int Field = 3; Field <= 24 && Cursor < End; ++Field) {
+		std::uint64_t Value = 0;
+		if (Field != 3) {
+			std::from_chars(Cursor, End, Value);
+		}
+		switch (Field) {
+			case 4: Out.parentPid = static_cast<ProcessID>(Value); break;
+			case 6: Out.sessionId = static_cast<std::uint32_t>(Value); break;
+			case 22: Out.startTime = Value; break;
+			case 24: Out.residentPages = Value; return true;
+		}
+		const void* Space = std::memchr(Cursor, ' ', static_cast<size_t>(End - Cursor));
+		if (!Space) {
+			break;
+		}
+		Cursor = static_cast<const char*>(Space) + 1;
+	}
+	return false;
+}
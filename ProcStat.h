@@ -0,0 +1,16 @@
+#pragma once
+#include "ProcessInfo.h"
+#include <cstdint>
+#include <string_view>
+
+// The fields of /proc/<pid>/stat the Linux backend uses
+struct ProcStat {
+	std::string_view name;
+	ProcessID parentPid = 0;       // Field 4
+	std::uint32_t sessionId = 0;   // Field 6
+	std::uint64_t startTime = 0;   // Field 22, clock ticks since boot
+	std::uint64_t residentPages = 0; // Field 24
+};
+
+// Parses the contents of /proc/<pid>/stat; name points into Stat. Plain text, so it builds everywhere.
+bool ParseStat(std::string_view Stat, ProcStat& Out);
@@ -0,0 +1,144 @@
+#include "ProcessEnumerator.h"
+
+// A burst of events (a build spawning compilers) is collected for this long after the first one,
+// so it costs one rebuild and one publish
+static constexpr std::chrono::milliseconds EventBatchWindow{ 50 };
+
+ProcessEnumerator::ProcessEnumerator(std::unique_ptr<ProcessSource> Source, std::function<void()> OnPublished)
+	: OnPublished(std::move(OnPublished)), Source(std::move(Source)) {}
+
+void ProcessEnumerator::Start() {
+	if (!Worker.joinable()) {
+		Worker = std::thread(&ProcessEnumerator::WorkerLoop, this);
+	}
+}
+
+ProcessEnumerator::~ProcessEnumerator() {
+	{
+		std::lock_guard Lock(WakeMutex);
+		StopRequested = true;
+	}
+	WakeWorker();
+	if (Worker.joinable()) {
+		Worker.join();
+	}
+}
+
+void ProcessEnumerator::RequestRefresh() {
+	{
+		std::lock_guard Lock(WakeMutex);
+		RefreshRequested = true;
+	}
+	WakeWorker();
+}
+
+void ProcessEnumerator::SetAutoRefreshInterval(std::chrono::milliseconds Interval) {
+	{
+		std::lock_guard Lock(WakeMutex);
+		AutoRefreshInterval = Interval;
+	}
+	WakeWorker(); // Restart the current wait with the new interval
+}
+
+void ProcessEnumerator::WakeWorker() {
+	{
+		std::lock_guard Lock(WakeMutex);
+		if (Events) {
+			Events->Wake();
+		}
+	}
+	WakeCondition.notify_one();
+}
+
+void ProcessEnumerator::WorkerLoop() {
+	// Subscribe before the first enumeration so processes started in between are not missed
+	std::unique_ptr<ProcessEventSource> Subscription = Source->CreateEventSource();
+	LiveUpdateName.store(Subscription ? Subscription->Name() : nullptr, std::memory_order_relaxed);
+
+	std::unique_lock Lock(WakeMutex);
+	Events = std::move(Subscription);
+	while (!StopRequested) {
+		if (Events && !RefreshRequested) {
+			// Auto-refresh still runs as a backstop, measured from the last full enumeration
+			std::chrono::milliseconds Timeout = std::chrono::milliseconds::max();
+			if (AutoRefreshInterval.count() > 0) {
+				const auto Elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - LastFullRefresh);
+				if (Elapsed >= AutoRefreshInterval) {
+					RefreshRequested = true;
+					continue;
+				}
+				Timeout = AutoRefreshInterval - Elapsed;
+			}
+			Lock.unlock();
+			ApplyProcessEvents(Timeout);
+			Lock.lock();
+			continue;
+		}
+
+		while (!StopRequested && !RefreshRequested) {
+			if (AutoRefreshInterval.count() > 0) {
+				if (WakeCondition.wait_for(Lock, AutoRefreshInterval) == std::cv_status::timeout) {
+					RefreshRequested = true;
+				}
+			} else {
+				WakeCondition.wait(Lock);
+			}
+		}
+		if (StopRequested) {
+			break;
+		}
+		RefreshRequested = false;
+
+		Lock.unlock();
+		LastFullRefresh = std::chrono::steady_clock::now();
+		// The first enumeration is always published so the UI can tell "empty" from "still loading"
+		if (Table.RefreshProcessIDList(*Source) || Version == 0) {
+			Publish();
+		}
+		Lock.lock();
+	}
+	Events.reset();
+}
+
+// Waits for process events and applies them to the table. Called without WakeMutex held;
+// Events stays valid because only this thread resets it.
+void ProcessEnumerator::ApplyProcessEvents(std::chrono::milliseconds Timeout) {
+	bool Received = false;
+	bool Overflowed = false;
+	Table.BeginEventBatch();
+	const auto Visit = [&](const ProcessEvent& Event) {
+		Received = true;
+		if (Event.type == ProcessEventType::Overflow) {
+			Overflowed = true;
+		} else {
+			Table.ApplyEvent(Event);
+		}
+	};
+
+	bool Alive = Events->WaitForEvents(Timeout, Visit);
+	if (Received) {
+		const auto Deadline = std::chrono::steady_clock::now() + EventBatchWindow;
+		for (auto Now = std::chrono::steady_clock::now(); Alive && Now < Deadline; Now = std::chrono::steady_clock::now()) {
+			Alive = Events->WaitForEvents(std::chrono::duration_cast<std::chrono::milliseconds>(Deadline - Now) + std::chrono::milliseconds(1), Visit);
+		}
+	}
+	if (Table.EndEventBatch()) {
+		Publish();
+	}
+
+	if (!Alive || Overflowed) {
+		std::lock_guard Lock(WakeMutex);
+		RefreshRequested = true; // Resynchronize with a full enumeration
+		if (!Alive) {
+			Events.reset();
+			LiveUpdateName.store(nullptr, std::memory_order_relaxed);
+		}
+	}
+}
+
+void ProcessEnumerator::Publish() {
+	LatestSnapshot.store(Table.MakeSnapshot(++Version), std::memory_order_release);
+	if (OnPublished) {
+		OnPublished();
+	}
+}
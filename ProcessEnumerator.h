@@ -0,0 +1,59 @@
+#pragma once
+#include "ProcessTable.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Enumerates processes on a worker thread and publishes immutable snapshots.
+// The render thread reads the latest snapshot with a single atomic load and never waits on the worker.
+// When the source offers live updates, the worker sleeps on them and applies start/exit events
+// between full enumerations instead of re-enumerating.
+struct ProcessEnumerator {
+private:
+	std::thread Worker;
+	std::mutex WakeMutex;
+	std::condition_variable WakeCondition;
+	bool RefreshRequested = true; // The first refresh runs as soon as the worker starts
+	bool StopRequested = false;
+	std::chrono::milliseconds AutoRefreshInterval{ 0 }; // 0 disables auto-refresh
+	std::function<void()> OnPublished;                 // Called on the worker after each publish
+
+	std::atomic<std::shared_ptr<const ProcessSnapshot>> LatestSnapshot;
+	std::atomic<const char*> LiveUpdateName{ nullptr };
+
+	// Created and reset by the worker under WakeMutex, so the wake-up paths can reach it
+	std::unique_ptr<ProcessEventSource> Events;
+
+	// Owned by the worker thread
+	std::unique_ptr<ProcessSource> Source;
+	ProcessTable Table;
+	unsigned long long Version = 0;
+	std::chrono::steady_clock::time_point LastFullRefresh;
+
+	void WorkerLoop();
+	void ApplyProcessEvents(std::chrono::milliseconds Timeout);
+	void Publish();
+	void WakeWorker();
+
+public:
+	// The worker is not started until Start(), so construction stays cheap on the startup path
+	ProcessEnumerator(std::unique_ptr<ProcessSource> Source, std::function<void()> OnPublished);
+	~ProcessEnumerator();
+
+	ProcessEnumerator(const ProcessEnumerator&) = delete;
+	ProcessEnumerator& operator=(const ProcessEnumerator&) = delete;
+
+	// Starts the worker and its first enumeration; later calls do nothing. Render thread only.
+	void Start();
+	void RequestRefresh();
+	void SetAutoRefreshInterval(std::chrono::milliseconds Interval);
+
+	// Null until the first enumeration has finished
+	std::shared_ptr<const ProcessSnapshot> Latest() const { return LatestSnapshot.load(std::memory_order_acquire); }
+	// Name of the event backend keeping the list current, or null when it only refreshes on demand
+	const char* LiveUpdateSource() const { return LiveUpdateName.load(std::memory_order_relaxed); }
+};
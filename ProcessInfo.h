@@ -0,0 +1,138 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <string> // Required for std::wstring
+#include <string_view>
+#include <functional>
+#include "ProcessSearchIndex.h"
+
+template<typename T>
+using DynamicArray = std::vector<T>;
+
+using ProcessID = std::uint32_t; // Same width as the Win32 DWORD PID and the Linux pid_t range
+
+// Identifies one process instance. PIDs are recycled, the creation time tells instances apart.
+struct ProcessKey {
+	ProcessID pid;
+	std::uint64_t creationTime; // Platform ticks (FILETIME on Windows, jiffies since boot on Linux), 0 when unknown
+
+	bool operator==(const ProcessKey& Other) const = default;
+};
+
+struct ProcessKeyHash {
+	size_t operator()(const ProcessKey& Key) const noexcept {
+		return std::hash<std::uint64_t>{}(Key.creationTime ^ (static_cast<std::uint64_t>(Key.pid) * 0x9E3779B97F4A7C15ull));
+	}
+};
+
+// Position of a string inside one of ProcessColumns' arenas
+struct ArenaSpan {
+	std::uint32_t Offset = 0;
+	std::uint32_t Length = 0; // Excludes the terminator labels are stored with
+};
+
+// The process list, stored structure-of-arrays with one entry per row in every row column.
+// Image names are interned (all svchost.exe rows share one NameId) and all text lives in two
+// arenas, so copying a table costs the same fixed number of allocations at any row count.
+struct ProcessColumns {
+	DynamicArray<ProcessID> Pids;
+	DynamicArray<std::uint64_t> CreationTimes;
+	DynamicArray<ProcessID> ParentPids;       // Free from both Toolhelp32 and /proc, so collected with the list
+	DynamicArray<std::uint32_t> NameIds;      // Index into NamesUtf8/NamesWide
+	DynamicArray<ArenaSpan> Labels;           // "Name (PID)" in Utf8Arena, null-terminated for ImGui
+
+	DynamicArray<ArenaSpan> NamesUtf8;        // Per NameId, in Utf8Arena
+	DynamicArray<ArenaSpan> NamesWide;        // Per NameId, in WideArena (UTF-16 on Windows)
+	std::string Utf8Arena;
+	std::wstring WideArena;
+
+	size_t Size() const { return Pids.size(); }
+	size_t NameCount() const { return NamesUtf8.size(); }
+	ProcessKey Key(size_t Row) const { return { Pids[Row], CreationTimes[Row] }; }
+	const char* Label(size_t Row) const { return Utf8Arena.data() + Labels[Row].Offset; }
+	std::string_view LabelView(size_t Row) const { return { Label(Row), Labels[Row].Length }; }
+	std::string_view NameUtf8(size_t Row) const {
+		const ArenaSpan& Span = NamesUtf8[NameIds[Row]];
+		return { Utf8Arena.data() + Span.Offset, Span.Length };
+	}
+	std::wstring_view Name(size_t Row) const {
+		const ArenaSpan& Span = NamesWide[NameIds[Row]];
+		return { WideArena.data() + Span.Offset, Span.Length };
+	}
+
+	// Empties every column but keeps the capacity
+	void Clear() {
+		Pids.clear();
+		CreationTimes.clear();
+		ParentPids.clear();
+		NameIds.clear();
+		Labels.clear();
+		NamesUtf8.clear();
+		NamesWide.clear();
+		Utf8Arena.clear();
+		WideArena.clear();
+	}
+};
+
+// PID -> row over a Pids column: open addressing with one allocation, no per-entry nodes
+struct ProcessRowLookup {
+private:
+	DynamicArray<std::uint32_t> Slots; // Row + 1, 0 = empty; a power of two at least twice the row count
+	unsigned Shift = 28;
+
+	size_t Home(ProcessID pid) const { return static_cast<size_t>((pid * 0x9E3779B1u) >> Shift); } // Fibonacci hashing; PIDs are often multiples of 4
+
+public:
+	void Build(const DynamicArray<ProcessID>& Pids) {
+		size_t SlotCount = 16;
+		Shift = 28;
+		while (SlotCount < Pids.size() * 2) {
+			SlotCount *= 2;
+			--Shift;
+		}
+		Slots.assign(SlotCount, 0); // Reuses the capacity when called again on a larger table
+		const size_t Mask = SlotCount - 1;
+		for (size_t Row = 0; Row < Pids.size(); ++Row) {
+			size_t Slot = Home(Pids[Row]);
+			while (Slots[Slot] != 0) {
+				Slot = (Slot + 1) & Mask;
+			}
+			Slots[Slot] = static_cast<std::uint32_t>(Row + 1);
+		}
+	}
+
+	// First row with this PID, or -1
+	int Find(ProcessID pid, const DynamicArray<ProcessID>& Pids) const {
+		if (Slots.empty()) {
+			return -1;
+		}
+		const size_t Mask = Slots.size() - 1;
+		for (size_t Slot = Home(pid); Slots[Slot] != 0; Slot = (Slot + 1) & Mask) {
+			if (Pids[Slots[Slot] - 1] == pid) {
+				return static_cast<int>(Slots[Slot] - 1);
+			}
+		}
+		return -1;
+	}
+};
+
+// Details that cost a process open or extra reads, fetched lazily per visible row
+struct ProcessMetadata {
+	static constexpr std::uint32_t UnknownSession = 0xFFFFFFFFu;
+
+	std::string imagePath;              // UTF-8 full image path, empty when access is denied
+	int bitness = 0;                    // 32 or 64, 0 when unknown
+	std::uint32_t sessionId = UnknownSession;
+	std::uint64_t workingSetBytes = 0;
+};
+
+// Immutable result of one enumeration, shared between the worker and the render thread
+struct ProcessSnapshot {
+	unsigned long long Version = 0; // Increases with every published change
+	ProcessColumns Processes;
+	ProcessRowLookup RowByPID;      // Built with the snapshot
+	ProcessSearchIndex SearchIndex; // Rows match Processes
+
+	// Returns -1 when the PID is not in this snapshot
+	int FindRow(ProcessID pid) const { return RowByPID.Find(pid, Processes.Pids); }
+};
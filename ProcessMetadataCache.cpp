@@ -0,0 +1,90 @@
+#include "ProcessMetadataCache.h"
+#include <algorithm>
+#include <unordered_set>
+
+ProcessMetadataCache::ProcessMetadataCache(std::unique_ptr<ProcessSource> Source, std::function<void()> OnResult, unsigned WorkerCount)
+	: Source(std::move(Source)), OnResult(std::move(OnResult)), WorkerCount(WorkerCount) {
+	if (this->WorkerCount == 0) {
+		// Queries are mostly kernel calls and small reads; a few threads hide their latency
+		this->WorkerCount = std::clamp(std::thread::hardware_concurrency() / 2, 2u, 4u);
+	}
+}
+
+ProcessMetadataCache::~ProcessMetadataCache() {
+	{
+		std::lock_guard Lock(CacheMutex);
+		StopRequested = true;
+	}
+	WorkAvailable.notify_all();
+	for (std::thread& Worker : Workers) {
+		Worker.join();
+	}
+}
+
+std::shared_ptr<const ProcessMetadata> ProcessMetadataCache::Get(const ProcessKey& Key) {
+	{
+		std::lock_guard Lock(CacheMutex);
+		auto [Found, Inserted] = Entries.try_emplace(Key);
+		Found->second.requestedFrame = Frame;
+		if (!Inserted) {
+			return Found->second.metadata;
+		}
+		Queue.push_back(Key);
+		if (Workers.empty()) {
+			for (unsigned Index = 0; Index < WorkerCount; ++Index) {
+				Workers.emplace_back(&ProcessMetadataCache::WorkerLoop, this); // They wait for CacheMutex like any wake-up
+			}
+		}
+	}
+	WorkAvailable.notify_one();
+	return nullptr;
+}
+
+void ProcessMetadataCache::BeginFrame() {
+	std::lock_guard Lock(CacheMutex);
+	++Frame;
+}
+
+void ProcessMetadataCache::Prune(const ProcessSnapshot& Snapshot) {
+	std::lock_guard Lock(CacheMutex);
+	std::erase_if(Entries, [&](const auto& Entry) {
+		const int Row = Snapshot.FindRow(Entry.first.pid);
+		return Row < 0 || Snapshot.Processes.CreationTimes[Row] != Entry.first.creationTime;
+	});
+	// Queued keys whose entry is gone are skipped by the workers
+}
+
+void ProcessMetadataCache::WorkerLoop() {
+	std::unique_lock Lock(CacheMutex);
+	while (true) {
+		WorkAvailable.wait(Lock, [this] { return StopRequested || !Queue.empty(); });
+		if (StopRequested) {
+			return;
+		}
+		const ProcessKey Key = Queue.back();
+		Queue.pop_back();
+		auto Queued = Entries.find(Key);
+		if (Queued == Entries.end()) {
+			continue; // Pruned while queued
+		}
+		if (Queued->second.requestedFrame + 1 < Frame) {
+			Entries.erase(Queued); // No longer on screen
+			continue;
+		}
+
+		Lock.unlock();
+		auto Metadata = std::make_shared<ProcessMetadata>();
+		Source->QueryMetadata(Key, *Metadata); // On failure the defaults read as "unknown" and are cached too
+		Lock.lock();
+
+		auto Found = Entries.find(Key);
+		if (Found != Entries.end()) {
+			Found->second.metadata = std::move(Metadata);
+			Lock.unlock();
+			if (OnResult) {
+				OnResult();
+			}
+			Lock.lock();
+		}
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "ProcessSource.h"
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+// Lazily fetched ProcessMetadata, keyed by PID plus creation time so a refresh never re-queries
+// a process it already described. Queries run on a small pool; Get() never blocks on one.
+// The pool is only started once something is queried, so a UI that never shows details pays nothing.
+struct ProcessMetadataCache {
+private:
+	std::unique_ptr<ProcessSource> Source; // QueryMetadata is safe to call concurrently
+	std::function<void()> OnResult;        // Called on a pool thread after each finished query
+
+	std::mutex CacheMutex;
+	std::condition_variable WorkAvailable;
+	struct Entry {
+		std::shared_ptr<const ProcessMetadata> metadata; // Null = queued or in flight; immutable once published
+		unsigned long long requestedFrame = 0;           // Last frame whose Get() asked for it
+	};
+	std::unordered_map<ProcessKey, Entry, ProcessKeyHash> Entries;
+	DynamicArray<ProcessKey> Queue; // Served newest first, so the rows on screen now win
+	unsigned long long Frame = 0;   // Advanced by BeginFrame()
+	bool StopRequested = false;
+	unsigned WorkerCount;
+	DynamicArray<std::thread> Workers; // Started by the first Get() that queues a query
+
+	void WorkerLoop();
+
+public:
+	ProcessMetadataCache(std::unique_ptr<ProcessSource> Source, std::function<void()> OnResult, unsigned WorkerCount = 0);
+	~ProcessMetadataCache();
+
+	ProcessMetadataCache(const ProcessMetadataCache&) = delete;
+	ProcessMetadataCache& operator=(const ProcessMetadataCache&) = delete;
+
+	// Returns the cached details, or null and queues a query the first time a key is seen
+	std::shared_ptr<const ProcessMetadata> Get(const ProcessKey& Key);
+	// Starts a new UI frame. Queued keys not requested in this frame or the previous one are
+	// dropped unqueried, so rows scrolled or filtered away stop costing queries; Get() requeues them.
+	void BeginFrame();
+	// Drops entries for processes that are no longer in the snapshot
+	void Prune(const ProcessSnapshot& Snapshot);
+};
@@ -0,0 +1,120 @@
+#include "ProcessModuleCache.h"
+#include <algorithm>
+
+ProcessModuleCache::ProcessModuleCache(std::unique_ptr<ProcessSource> Source, std::function<void()> OnResult)
+	: Source(std::move(Source)), OnResult(std::move(OnResult)) {}
+
+ProcessModuleCache::~ProcessModuleCache() {
+	{
+		std::lock_guard Lock(CacheMutex);
+		StopRequested = true;
+	}
+	WorkAvailable.notify_all();
+	if (Worker.joinable()) {
+		Worker.join();
+	}
+}
+
+// CacheMutex must be held
+void ProcessModuleCache::Enqueue(const ProcessKey& Key, Entry& Target) {
+	if (Target.Queued) {
+		return;
+	}
+	Target.Queued = true;
+	Queue.push_back(Key);
+	if (!Worker.joinable()) {
+		Worker = std::thread(&ProcessModuleCache::WorkerLoop, this);
+	}
+	WorkAvailable.notify_one();
+}
+
+std::shared_ptr<const ProcessModuleList> ProcessModuleCache::Get(const ProcessKey& Key) {
+	std::lock_guard Lock(CacheMutex);
+	auto [Found, Inserted] = Entries.try_emplace(Key);
+	if (Inserted) {
+		Enqueue(Key, Found->second);
+	}
+	return Found->second.Modules;
+}
+
+void ProcessModuleCache::Refresh(const ProcessKey& Key) {
+	std::lock_guard Lock(CacheMutex);
+	auto Found = Entries.find(Key);
+	if (Found != Entries.end()) {
+		Enqueue(Key, Found->second);
+	}
+}
+
+bool ProcessModuleCache::IsRefreshing(const ProcessKey& Key) {
+	std::lock_guard Lock(CacheMutex);
+	auto Found = Entries.find(Key);
+	return Found != Entries.end() && (Found->second.Queued || Found->second.Running);
+}
+
+void ProcessModuleCache::Prune(const ProcessSnapshot& Snapshot) {
+	std::lock_guard Lock(CacheMutex);
+	std::erase_if(Entries, [&](const auto& Entry) {
+		const int Row = Snapshot.FindRow(Entry.first.pid);
+		return Row < 0 || Snapshot.Processes.CreationTimes[Row] != Entry.first.creationTime;
+	});
+	// Queued keys whose entry is gone are skipped by the worker
+}
+
+void ProcessModuleCache::WorkerLoop() {
+	std::unique_lock Lock(CacheMutex);
+	while (true) {
+		WorkAvailable.wait(Lock, [this] { return StopRequested || !Queue.empty(); });
+		if (StopRequested) {
+			return;
+		}
+		const ProcessKey Key = Queue.front();
+		Queue.erase(Queue.begin()); // Requests are rare; first come, first served
+		auto Found = Entries.find(Key);
+		if (Found == Entries.end()) {
+			continue; // Pruned while queued
+		}
+		// No longer queued, so a Refresh() during the enumeration queues a pass that will see its changes
+		Found->second.Queued = false;
+		Found->second.Running = true;
+		const std::shared_ptr<const ProcessModuleList> Previous = Found->second.Modules;
+
+		Lock.unlock();
+		auto Modules = std::make_shared<ProcessModuleList>();
+		Modules->captured = std::chrono::system_clock::now();
+		// Previous modules by base address; a match with the same size and path is carried over as is
+		std::unordered_map<std::uint64_t, const ProcessModule*> PreviousByBase;
+		if (Previous) {
+			PreviousByBase.reserve(Previous->modules.size());
+			for (const ProcessModule& Module : Previous->modules) {
+				PreviousByBase.emplace(Module.base, &Module);
+			}
+		}
+		size_t Unchanged = 0;
+		Modules->available = Source->EnumerateModules(Key, [&](const ProcessModuleEntry& Entry) {
+			const auto Match = PreviousByBase.find(Entry.base);
+			if (Match != PreviousByBase.end() && Match->second->size == Entry.size && Match->second->path == Entry.path) {
+				ProcessModule& Module = Modules->modules.emplace_back(*Match->second);
+				Module.added = false;
+				++Unchanged;
+				return;
+			}
+			// Everything is new on the first enumeration, so nothing is flagged then
+			Modules->modules.push_back({ Entry.base, Entry.size, std::string(Entry.path), Previous != nullptr && Previous->available });
+		});
+		if (Previous && Modules->available) {
+			Modules->removedCount = Previous->modules.size() - Unchanged;
+		}
+		Lock.lock();
+
+		Found = Entries.find(Key);
+		if (Found != Entries.end()) {
+			Found->second.Modules = std::move(Modules);
+			Found->second.Running = false;
+			Lock.unlock();
+			if (OnResult) {
+				OnResult();
+			}
+			Lock.lock();
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "ProcessSource.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+struct ProcessModule {
+	std::uint64_t base = 0;
+	std::uint64_t size = 0;
+	std::string path;   // UTF-8
+	bool added = false; // Not in the previous enumeration of this process, e.g. a DLL that was just injected
+};
+
+// The modules of one process as of one enumeration; immutable once published
+struct ProcessModuleList {
+	bool available = false;         // False when the process could not be read
+	DynamicArray<ProcessModule> modules;
+	size_t removedCount = 0;        // Modules of the previous enumeration that are gone
+	std::chrono::system_clock::time_point captured;
+};
+
+// Loaded modules per process, enumerated lazily on one worker thread and kept until the process exits.
+// A refresh diffs against the previous list, so unchanged modules reuse it and new ones are flagged.
+// The previous list stays visible while a refresh runs; Get() never blocks on the worker.
+struct ProcessModuleCache {
+private:
+	struct Entry {
+		std::shared_ptr<const ProcessModuleList> Modules; // Null until the first enumeration finishes
+		bool Queued = false;  // Waiting in Queue
+		bool Running = false; // Being enumerated; a Refresh() now queues another pass
+	};
+
+	std::unique_ptr<ProcessSource> Source; // EnumerateModules is safe to call off the render thread
+	std::function<void()> OnResult;        // Called on the worker after each finished enumeration
+
+	std::mutex CacheMutex;
+	std::condition_variable WorkAvailable;
+	std::unordered_map<ProcessKey, Entry, ProcessKeyHash> Entries;
+	DynamicArray<ProcessKey> Queue;
+	bool StopRequested = false;
+	std::thread Worker; // Started by the first enumeration request
+
+	void Enqueue(const ProcessKey& Key, Entry& Target);
+	void WorkerLoop();
+
+public:
+	ProcessModuleCache(std::unique_ptr<ProcessSource> Source, std::function<void()> OnResult);
+	~ProcessModuleCache();
+
+	ProcessModuleCache(const ProcessModuleCache&) = delete;
+	ProcessModuleCache& operator=(const ProcessModuleCache&) = delete;
+
+	// Returns the cached list, or null and queues an enumeration the first time a key is seen
+	std::shared_ptr<const ProcessModuleList> Get(const ProcessKey& Key);
+	// Queues a re-enumeration of a process Get() has seen, unless one is already waiting to start
+	void Refresh(const ProcessKey& Key);
+	bool IsRefreshing(const ProcessKey& Key);
+	// Drops lists of processes that are no longer in the snapshot
+	void Prune(const ProcessSnapshot& Snapshot);
+};
@@ -0,0 +1,164 @@
+#include "ProcessSearchIndex.h"
+#include <algorithm>
+#include <numeric>
+
+static uint32_t PackTrigram(const char* Text) {
+	return (static_cast<uint32_t>(static_cast<unsigned char>(Text[0])) << 16) |
+		(static_cast<uint32_t>(static_cast<unsigned char>(Text[1])) << 8) |
+		static_cast<uint32_t>(static_cast<unsigned char>(Text[2]));
+}
+
+// ASCII only: UTF-8 continuation bytes are left untouched
+static char LowerAscii(char c) {
+	return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+void ProcessSearchIndex::ToLower(std::string_view Text, std::string& Out) {
+	Out.resize(Text.size());
+	std::transform(Text.begin(), Text.end(), Out.begin(), LowerAscii);
+}
+
+void ProcessSearchIndex::Reserve(size_t RowCount, size_t TextBytes) {
+	LabelOffsets.reserve(RowCount + 1);
+	LowercaseText.reserve(TextBytes);
+}
+
+void ProcessSearchIndex::Add(std::string_view Label) {
+	const size_t Start = LowercaseText.size();
+	LowercaseText.resize(Start + Label.size());
+	std::transform(Label.begin(), Label.end(), LowercaseText.begin() + Start, LowerAscii);
+	LabelOffsets.push_back(static_cast<uint32_t>(LowercaseText.size()));
+}
+
+void ProcessSearchIndex::Finish() {
+	// One (trigram << 32 | row) pair per trigram occurrence, generated in row order
+	size_t PairCount = 0;
+	for (uint32_t Row = 0; Row < Size(); ++Row) {
+		const size_t Length = LabelOffsets[Row + 1] - LabelOffsets[Row];
+		PairCount += Length >= 3 ? Length - 2 : 0;
+	}
+	std::vector<uint64_t> Pairs(PairCount);
+	std::vector<uint64_t> Sorted(PairCount);
+	size_t Next = 0;
+	for (uint32_t Row = 0; Row < Size(); ++Row) {
+		for (uint32_t Offset = LabelOffsets[Row]; Offset + 3 <= LabelOffsets[Row + 1]; ++Offset) {
+			Pairs[Next++] = (static_cast<uint64_t>(PackTrigram(LowercaseText.data() + Offset)) << 32) | Row;
+		}
+	}
+
+	// Stable LSD radix sort on the 24-bit trigram; stability keeps each trigram's rows ascending
+	for (unsigned Shift = 32; Shift < 56; Shift += 8) {
+		size_t Counts[257] = {};
+		for (uint64_t Pair : Pairs) {
+			++Counts[((Pair >> Shift) & 0xFF) + 1];
+		}
+		for (size_t Bucket = 1; Bucket < 257; ++Bucket) {
+			Counts[Bucket] += Counts[Bucket - 1];
+		}
+		for (uint64_t Pair : Pairs) {
+			Sorted[Counts[(Pair >> Shift) & 0xFF]++] = Pair;
+		}
+		Pairs.swap(Sorted);
+	}
+
+	// Count first so the CSR arrays are allocated exactly once
+	size_t TrigramCount = 0, RowCount = 0;
+	for (size_t Index = 0; Index < Pairs.size(); ++Index) {
+		if (Index == 0 || (Pairs[Index] >> 32) != (Pairs[Index - 1] >> 32)) {
+			++TrigramCount;
+			++RowCount;
+		} else if (Pairs[Index] != Pairs[Index - 1]) {
+			++RowCount; // The same trigram twice in one label is listed once
+		}
+	}
+	Trigrams.clear();
+	Trigrams.reserve(TrigramCount);
+	TrigramRowStart.clear();
+	TrigramRowStart.reserve(TrigramCount + 1);
+	TrigramRows.clear();
+	TrigramRows.reserve(RowCount);
+	for (size_t Index = 0; Index < Pairs.size(); ++Index) {
+		const uint32_t Trigram = static_cast<uint32_t>(Pairs[Index] >> 32);
+		if (Trigrams.empty() || Trigrams.back() != Trigram) {
+			Trigrams.push_back(Trigram);
+			TrigramRowStart.push_back(static_cast<uint32_t>(TrigramRows.size()));
+		} else if (Pairs[Index] == Pairs[Index - 1]) {
+			continue;
+		}
+		TrigramRows.push_back(static_cast<uint32_t>(Pairs[Index]));
+	}
+	TrigramRowStart.push_back(static_cast<uint32_t>(TrigramRows.size()));
+}
+
+bool ProcessSearchIndex::Matches(uint32_t Row, std::string_view LowercaseQuery) const {
+	return LowercaseLabel(Row).find(LowercaseQuery) != std::string_view::npos;
+}
+
+void ProcessSearchIndex::Search(std::string_view LowercaseQuery, std::vector<uint32_t>& OutRows) const {
+	if (LowercaseQuery.size() < 3) {
+		// Too short for a trigram; a linear scan over short lowercase strings is cheap enough
+		for (uint32_t Row = 0; Row < Size(); ++Row) {
+			if (Matches(Row, LowercaseQuery)) {
+				OutRows.push_back(Row);
+			}
+		}
+		return;
+	}
+
+	size_t CandidatesBegin = 0, CandidatesEnd = 0;
+	bool HaveCandidates = false;
+	for (size_t Offset = 0; Offset + 3 <= LowercaseQuery.size(); ++Offset) {
+		const uint32_t Trigram = PackTrigram(LowercaseQuery.data() + Offset);
+		auto Found = std::lower_bound(Trigrams.begin(), Trigrams.end(), Trigram);
+		if (Found == Trigrams.end() || *Found != Trigram) {
+			return; // A trigram nobody has: no matches
+		}
+		const size_t Position = static_cast<size_t>(Found - Trigrams.begin());
+		const size_t Begin = TrigramRowStart[Position], End = TrigramRowStart[Position + 1];
+		if (!HaveCandidates || End - Begin < CandidatesEnd - CandidatesBegin) {
+			CandidatesBegin = Begin;
+			CandidatesEnd = End;
+			HaveCandidates = true;
+		}
+	}
+	for (size_t Candidate = CandidatesBegin; Candidate < CandidatesEnd; ++Candidate) {
+		if (Matches(TrigramRows[Candidate], LowercaseQuery)) {
+			OutRows.push_back(TrigramRows[Candidate]);
+		}
+	}
+}
+
+bool ProcessFilter::Update(const ProcessSearchIndex& Index, unsigned long long Version, std::string_view Query) {
+	const bool SameIndex = HasResult && Version == IndexVersion;
+	if (SameIndex && Query == RawQuery) {
+		return false;
+	}
+
+	std::string NewLowercaseQuery;
+	ProcessSearchIndex::ToLower(Query, NewLowercaseQuery);
+
+	if (SameIndex && !LowercaseQuery.empty() && NewLowercaseQuery.find(LowercaseQuery) != std::string::npos) {
+		// Narrowing: every match of the new query also matched the previous one
+		std::erase_if(Rows, [&](uint32_t Row) { return !Index.Matches(Row, NewLowercaseQuery); });
+	} else if (NewLowercaseQuery.empty()) {
+		Rows.resize(Index.Size());
+		std::iota(Rows.begin(), Rows.end(), 0u);
+	} else {
+		Rows.clear();
+		Index.Search(NewLowercaseQuery, Rows);
+	}
+
+	IndexVersion = Version;
+	RawQuery.assign(Query);
+	LowercaseQuery = std::move(NewLowercaseQuery);
+	HasResult = true;
+	return true;
+}
+
+void ProcessFilter::Reset() {
+	IndexVersion = 0;
+	RawQuery.clear();
+	LowercaseQuery.clear();
+	Rows.clear();
+	HasResult = false;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Search data built once per snapshot: lowercased labels plus a trigram -> rows table.
+// Queries of three or more characters only verify the rows listed under their rarest trigram.
+// Everything is stored in flat arrays (the trigram table in CSR form), so building an index
+// allocates a fixed number of times however many rows it has.
+struct ProcessSearchIndex {
+private:
+	std::string LowercaseText;              // All lowercased labels back to back
+	std::vector<uint32_t> LabelOffsets{ 0 }; // Row r is [LabelOffsets[r], LabelOffsets[r + 1]) of LowercaseText
+	std::vector<uint32_t> Trigrams;         // Sorted, unique
+	std::vector<uint32_t> TrigramRowStart;  // Trigrams.size() + 1 offsets into TrigramRows
+	std::vector<uint32_t> TrigramRows;      // Rows ascending per trigram, each row at most once
+
+	std::string_view LowercaseLabel(uint32_t Row) const {
+		return std::string_view(LowercaseText).substr(LabelOffsets[Row], LabelOffsets[Row + 1] - LabelOffsets[Row]);
+	}
+
+public:
+	void Reserve(size_t RowCount, size_t TextBytes);
+	void Add(std::string_view Label); // Rows are numbered in the order they are added
+	// Builds the trigram table; call once after the last Add() and before searching
+	void Finish();
+	size_t Size() const { return LabelOffsets.size() - 1; }
+
+	bool Matches(uint32_t Row, std::string_view LowercaseQuery) const;
+	// Appends the rows whose label contains the query, in ascending order
+	void Search(std::string_view LowercaseQuery, std::vector<uint32_t>& OutRows) const;
+
+	static void ToLower(std::string_view Text, std::string& Out);
+};
+
+// Filter state over one snapshot's index. When the new query contains the previous one
+// the previous result set is narrowed instead of searching the index again.
+struct ProcessFilter {
+private:
+	unsigned long long IndexVersion = 0;
+	std::string RawQuery;
+	std::string LowercaseQuery;
+	std::vector<uint32_t> Rows; // Ascending
+	bool HasResult = false;
+
+public:
+	// Returns true when MatchingRows() changed
+	bool Update(const ProcessSearchIndex& Index, unsigned long long Version, std::string_view Query);
+	void Reset();
+
+	bool IsFiltering() const { return !LowercaseQuery.empty(); }
+	const std::vector<uint32_t>& MatchingRows() const { return Rows; }
+};
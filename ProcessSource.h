@@ -0,0 +1,78 @@
+#pragma once
+#include "ProcessInfo.h"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string_view>
+
+// One process as reported by a ProcessSource. The views are only valid during the callback;
+// a backend sets whichever name encoding it has natively and the consumer converts on demand.
+struct ProcessSourceEntry {
+	ProcessID pid = 0;
+	std::uint64_t creationTime = 0;
+	ProcessID parentPid = 0;
+	std::wstring_view wideName;
+	std::string_view utf8Name;
+};
+
+// One module loaded in a process. The path view is only valid during the callback.
+struct ProcessModuleEntry {
+	std::uint64_t base = 0;
+	std::uint64_t size = 0;
+	std::string_view path; // UTF-8
+};
+
+enum class ProcessEventType {
+	Started,  // A new process, or a known one whose name changed (exec)
+	Exited,   // Only pid, and creationTime when the backend knows it, are set
+	Overflow, // Events were lost; the consumer must re-enumerate to resynchronize
+};
+
+struct ProcessEvent {
+	ProcessEventType type = ProcessEventType::Started;
+	ProcessSourceEntry process;
+};
+
+// Push-based process start/exit notifications, consumed by ProcessTable's event batches
+struct ProcessEventSource {
+	virtual ~ProcessEventSource() = default;
+
+	// Short backend name for the UI, e.g. "netlink"
+	virtual const char* Name() const = 0;
+
+	// Waits up to Timeout for events and calls Visit for each one that arrived. Returns false once
+	// the source has failed for good; the caller then falls back to full enumerations.
+	virtual bool WaitForEvents(std::chrono::milliseconds Timeout, const std::function<void(const ProcessEvent&)>& Visit) = 0;
+
+	// Makes a pending or the next WaitForEvents return early. Thread-safe.
+	virtual void Wake() = 0;
+};
+
+// Platform backend for process enumeration, consumed by ProcessTable::RefreshProcessIDList
+struct ProcessSource {
+	virtual ~ProcessSource() = default;
+
+	// Calls Visit once per running process. Returns false if the enumeration itself failed.
+	virtual bool Enumerate(const std::function<void(const ProcessSourceEntry&)>& Visit) = 0;
+
+	// Fills the lazily collected details for one process. Must be safe to call from several
+	// threads at once, and should fail rather than describe a different process that reused the PID.
+	virtual bool QueryMetadata(const ProcessKey& Key, ProcessMetadata& Out) const = 0;
+
+	// Calls Visit once per module loaded in the process. Same threading and PID-reuse rules as QueryMetadata;
+	// returns false when the process cannot be read or the backend has no module list.
+	virtual bool EnumerateModules(const ProcessKey&, const std::function<void(const ProcessModuleEntry&)>&) const { return false; }
+
+	// Live updates for this source, or null when it only supports full enumerations. Subscribe
+	// before the first Enumerate so nothing that starts in between is missed.
+	virtual std::unique_ptr<ProcessEventSource> CreateEventSource() { return nullptr; }
+};
+
+// Toolhelp32 on Windows, /proc on Linux. Live updates come from the kernel process ETW provider
+// on Windows and the netlink proc connector on Linux, falling back to a /proc PID poll.
+std::unique_ptr<ProcessSource> CreatePlatformProcessSource();
+
+// Deterministic fake processes for benchmarks. Each enumeration replaces ChurnPerRefresh
+// of the processes with new ones, so incremental refresh paths get exercised.
+std::unique_ptr<ProcessSource> CreateSyntheticProcessSource(size_t ProcessCount, unsigned Seed = 1, double ChurnPerRefresh = 0.0);
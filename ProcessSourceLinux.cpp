@@ -0,0 +1,423 @@
+#include "ProcStat.h"
+#include "ProcessSource.h"
+#include <algorithm>
+#include <charconv>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Reads a small /proc file into Buffer; returns the byte count, or -1 when it vanished
+static ssize_t ReadProcFile(const char* Path, char* Buffer, size_t BufferSize) {
+	int Descriptor = open(Path, O_RDONLY | O_CLOEXEC);
+	if (Descriptor < 0) {
+		return -1;
+	}
+	ssize_t Total = 0;
+	while (static_cast<size_t>(Total) < BufferSize) {
+		ssize_t Count = read(Descriptor, Buffer + Total, BufferSize - static_cast<size_t>(Total));
+		if (Count <= 0) {
+			break;
+		}
+		Total += Count;
+	}
+	close(Descriptor);
+	return Total;
+}
+
+// ELF class byte of the executable: 1 = 32-bit, 2 = 64-bit
+static int ReadExecutableBitness(ProcessID Pid) {
+	char Path[64];
+	std::snprintf(Path, sizeof(Path), "/proc/%u/exe", Pid);
+	unsigned char Header[5];
+	if (ReadProcFile(Path, reinterpret_cast<char*>(Header), sizeof(Header)) != sizeof(Header) ||
+		Header[0] != 0x7F || Header[1] != 'E' || Header[2] != 'L' || Header[3] != 'F') {
+		return 0;
+	}
+	return Header[4] == 1 ? 32 : (Header[4] == 2 ? 64 : 0);
+}
+
+// Parses a /proc directory entry name; false for everything that is not a process
+static bool ParsePIDDirectory(const char* Name, ProcessID& Pid) {
+	const char* NameEnd = Name + std::strlen(Name);
+	auto [Last, Error] = std::from_chars(Name, NameEnd, Pid);
+	return Error == std::errc() && Last == NameEnd;
+}
+
+// Reads one process into Entry; the name points into Stat
+static bool ReadProcessEntry(ProcessID Pid, char (&Stat)[1024], ProcessSourceEntry& Entry) {
+	char Path[64];
+	std::snprintf(Path, sizeof(Path), "/proc/%u/stat", Pid);
+	const ssize_t Length = ReadProcFile(Path, Stat, sizeof(Stat));
+	ProcStat Parsed;
+	if (Length <= 0 || !ParseStat(std::string_view(Stat, static_cast<size_t>(Length)), Parsed)) {
+		return false; // Already exited
+	}
+	Entry.pid = Pid;
+	Entry.creationTime = Parsed.startTime;
+	Entry.parentPid = Parsed.parentPid;
+	Entry.utf8Name = Parsed.name;
+	return true;
+}
+
+static int PollTimeout(std::chrono::milliseconds Timeout) {
+	return Timeout.count() > INT_MAX ? -1 : static_cast<int>(std::max<std::chrono::milliseconds::rep>(Timeout.count(), 0));
+}
+
+// An eventfd that Wake() signals and WaitForEvents() polls alongside its own descriptor
+struct WakeDescriptor {
+	int Descriptor = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+	WakeDescriptor() = default;
+	WakeDescriptor(const WakeDescriptor&) = delete;
+	WakeDescriptor& operator=(const WakeDescriptor&) = delete;
+	~WakeDescriptor() {
+		if (Descriptor >= 0) {
+			close(Descriptor);
+		}
+	}
+
+	void Signal() const {
+		const std::uint64_t One = 1;
+		(void)!write(Descriptor, &One, sizeof(One));
+	}
+	void Drain() const {
+		std::uint64_t Count;
+		(void)!read(Descriptor, &Count, sizeof(Count));
+	}
+};
+
+// The kernel's process connector: fork, exec, comm and exit events pushed over netlink.
+// Joining its multicast group needs CAP_NET_ADMIN, so creation fails for most users.
+struct NetlinkProcessEventSource : ProcessEventSource {
+private:
+	int Socket = -1;
+	WakeDescriptor WakeSignal;
+	alignas(nlmsghdr) char Buffer[8192];
+	char Stat[1024];
+
+	bool Subscribe(proc_cn_mcast_op Operation) {
+		alignas(nlmsghdr) char Request[NLMSG_SPACE(sizeof(cn_msg) + sizeof(proc_cn_mcast_op))] = {};
+		nlmsghdr* Header = reinterpret_cast<nlmsghdr*>(Request);
+		Header->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(proc_cn_mcast_op));
+		Header->nlmsg_type = NLMSG_DONE;
+		cn_msg* Message = static_cast<cn_msg*>(NLMSG_DATA(Header));
+		Message->id.idx = CN_IDX_PROC;
+		Message->id.val = CN_VAL_PROC;
+		Message->len = sizeof(proc_cn_mcast_op);
+		std::memcpy(Message->data, &Operation, sizeof(Operation));
+		return send(Socket, Request, Header->nlmsg_len, 0) == static_cast<ssize_t>(Header->nlmsg_len);
+	}
+
+	void VisitStarted(ProcessID Pid, const std::function<void(const ProcessEvent&)>& Visit) {
+		ProcessEvent Event;
+		if (ReadProcessEntry(Pid, Stat, Event.process)) {
+			Visit(Event);
+		} // Otherwise it exited already, and its exit event follows
+	}
+
+	void VisitMessage(const proc_event& Data, const std::function<void(const ProcessEvent&)>& Visit) {
+		// Thread events are skipped: only thread group leaders are processes
+		switch (Data.what) {
+			case proc_event::PROC_EVENT_FORK:
+				if (Data.event_data.fork.child_pid == Data.event_data.fork.child_tgid) {
+					VisitStarted(static_cast<ProcessID>(Data.event_data.fork.child_tgid), Visit);
+				}
+				break;
+			case proc_event::PROC_EVENT_EXEC:
+				VisitStarted(static_cast<ProcessID>(Data.event_data.exec.process_tgid), Visit);
+				break;
+			case proc_event::PROC_EVENT_COMM:
+				if (Data.event_data.comm.process_pid == Data.event_data.comm.process_tgid) {
+					VisitStarted(static_cast<ProcessID>(Data.event_data.comm.process_tgid), Visit);
+				}
+				break;
+			case proc_event::PROC_EVENT_EXIT:
+				if (Data.event_data.exit.process_pid == Data.event_data.exit.process_tgid) {
+					ProcessEvent Event;
+					Event.type = ProcessEventType::Exited;
+					Event.process.pid = static_cast<ProcessID>(Data.event_data.exit.process_tgid);
+					Visit(Event);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+
+public:
+	NetlinkProcessEventSource() {
+		Socket = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_CONNECTOR);
+		if (Socket < 0) {
+			return;
+		}
+		sockaddr_nl Address = {};
+		Address.nl_family = AF_NETLINK;
+		Address.nl_groups = CN_IDX_PROC;
+		if (bind(Socket, reinterpret_cast<sockaddr*>(&Address), sizeof(Address)) != 0 || !Subscribe(PROC_CN_MCAST_LISTEN)) {
+			close(Socket);
+			Socket = -1;
+		}
+	}
+
+	~NetlinkProcessEventSource() override {
+		if (Socket >= 0) {
+			Subscribe(PROC_CN_MCAST_IGNORE);
+			close(Socket);
+		}
+	}
+
+	bool IsSubscribed() const { return Socket >= 0 && WakeSignal.Descriptor >= 0; }
+
+	const char* Name() const override { return "netlink"; }
+
+	bool WaitForEvents(std::chrono::milliseconds Timeout, const std::function<void(const ProcessEvent&)>& Visit) override {
+		pollfd Descriptors[2] = { { Socket, POLLIN, 0 }, { WakeSignal.Descriptor, POLLIN, 0 } };
+		if (poll(Descriptors, 2, PollTimeout(Timeout)) < 0) {
+			return errno == EINTR;
+		}
+		if (Descriptors[1].revents & POLLIN) {
+			WakeSignal.Drain();
+		}
+		if (!(Descriptors[0].revents & (POLLIN | POLLERR))) {
+			return true;
+		}
+
+		for (;;) {
+			const ssize_t Length = recv(Socket, Buffer, sizeof(Buffer), 0);
+			if (Length < 0) {
+				if (errno == ENOBUFS) {
+					ProcessEvent Event; // The socket buffer overran during a burst
+					Event.type = ProcessEventType::Overflow;
+					Visit(Event);
+					continue;
+				}
+				return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+			}
+			int Remaining = static_cast<int>(Length);
+			for (nlmsghdr* Header = reinterpret_cast<nlmsghdr*>(Buffer); NLMSG_OK(Header, Remaining); Header = NLMSG_NEXT(Header, Remaining)) {
+				if (Header->nlmsg_type == NLMSG_ERROR || Header->nlmsg_type == NLMSG_NOOP) {
+					continue;
+				}
+				const cn_msg* Message = static_cast<const cn_msg*>(NLMSG_DATA(Header));
+				if (Message->id.idx == CN_IDX_PROC && Message->id.val == CN_VAL_PROC && Message->len >= sizeof(proc_event)) {
+					proc_event Data;
+					std::memcpy(&Data, Message->data, sizeof(Data));
+					VisitMessage(Data, Visit);
+				}
+			}
+		}
+	}
+
+	void Wake() override { WakeSignal.Signal(); }
+};
+
+// Fallback for unprivileged users. inotify reports nothing for procfs directories, so this
+// lists /proc's PIDs once a second and reads /proc/<pid>/stat only for the new ones.
+struct ProcfsPollingEventSource : ProcessEventSource {
+private:
+	static constexpr std::chrono::milliseconds PollInterval{ 1000 };
+
+	WakeDescriptor WakeSignal;
+	DynamicArray<ProcessID> KnownPids; // Sorted
+	DynamicArray<ProcessID> CurrentPids;
+	std::chrono::steady_clock::time_point NextPoll;
+	char Stat[1024];
+
+	bool ListPids(DynamicArray<ProcessID>& Out) const {
+		DIR* ProcDirectory = opendir("/proc");
+		if (!ProcDirectory) {
+			return false;
+		}
+		Out.clear();
+		while (dirent* DirectoryEntry = readdir(ProcDirectory)) {
+			ProcessID Pid = 0;
+			if (ParsePIDDirectory(DirectoryEntry->d_name, Pid)) {
+				Out.push_back(Pid);
+			}
+		}
+		closedir(ProcDirectory);
+		std::sort(Out.begin(), Out.end());
+		return true;
+	}
+
+public:
+	ProcfsPollingEventSource() : NextPoll(std::chrono::steady_clock::now() + PollInterval) {
+		ListPids(KnownPids);
+	}
+
+	bool IsValid() const { return WakeSignal.Descriptor >= 0; }
+
+	const char* Name() const override { return "/proc poll"; }
+
+	bool WaitForEvents(std::chrono::milliseconds Timeout, const std::function<void(const ProcessEvent&)>& Visit) override {
+		const auto UntilPoll = std::chrono::ceil<std::chrono::milliseconds>(NextPoll - std::chrono::steady_clock::now());
+		pollfd Descriptor = { WakeSignal.Descriptor, POLLIN, 0 };
+		if (poll(&Descriptor, 1, PollTimeout(std::min(Timeout, UntilPoll))) < 0 && errno != EINTR) {
+			return false;
+		}
+		if (Descriptor.revents & POLLIN) {
+			WakeSignal.Drain();
+		}
+		const auto Now = std::chrono::steady_clock::now();
+		if (Now < NextPoll) {
+			return true;
+		}
+		NextPoll = Now + PollInterval;
+		if (!ListPids(CurrentPids)) {
+			return false;
+		}
+
+		// Both lists are sorted, so one merge pass finds the starts and exits
+		auto Known = KnownPids.begin();
+		auto Current = CurrentPids.begin();
+		while (Known != KnownPids.end() || Current != CurrentPids.end()) {
+			ProcessEvent Event;
+			if (Current == CurrentPids.end() || (Known != KnownPids.end() && *Known < *Current)) {
+				Event.type = ProcessEventType::Exited;
+				Event.process.pid = *Known++;
+				Visit(Event);
+			} else if (Known == KnownPids.end() || *Current < *Known) {
+				if (ReadProcessEntry(*Current++, Stat, Event.process)) {
+					Visit(Event);
+				}
+			} else {
+				++Known;
+				++Current;
+			}
+		}
+		std::swap(KnownPids, CurrentPids);
+		return true;
+	}
+
+	void Wake() override { WakeSignal.Signal(); }
+};
+
+struct ProcfsProcessSource : ProcessSource {
+	bool Enumerate(const std::function<void(const ProcessSourceEntry&)>& Visit) override {
+		DIR* ProcDirectory = opendir("/proc");
+		if (!ProcDirectory) {
+			return false;
+		}
+
+		char Stat[1024];
+		while (dirent* DirectoryEntry = readdir(ProcDirectory)) {
+			ProcessID Pid = 0;
+			ProcessSourceEntry Entry;
+			if (ParsePIDDirectory(DirectoryEntry->d_name, Pid) && ReadProcessEntry(Pid, Stat, Entry)) {
+				Visit(Entry); // Skipped when it exited between readdir and open
+			}
+		}
+		closedir(ProcDirectory);
+		return true;
+	}
+
+	bool QueryMetadata(const ProcessKey& Key, ProcessMetadata& Out) const override {
+		static const long PageSize = sysconf(_SC_PAGESIZE);
+
+		char Path[64];
+		char Stat[1024];
+		std::snprintf(Path, sizeof(Path), "/proc/%u/stat", Key.pid);
+		const ssize_t Length = ReadProcFile(Path, Stat, sizeof(Stat));
+		ProcStat Parsed;
+		if (Length <= 0 || !ParseStat(std::string_view(Stat, static_cast<size_t>(Length)), Parsed) ||
+			Parsed.startTime != Key.creationTime) {
+			return false; // Exited, or the PID now belongs to another process
+		}
+		Out.sessionId = Parsed.sessionId;
+		Out.workingSetBytes = Parsed.residentPages * static_cast<std::uint64_t>(PageSize);
+
+		char ImagePath[4096];
+		std::snprintf(Path, sizeof(Path), "/proc/%u/exe", Key.pid);
+		const ssize_t ImagePathLength = readlink(Path, ImagePath, sizeof(ImagePath));
+		if (ImagePathLength > 0) {
+			Out.imagePath.assign(ImagePath, static_cast<size_t>(ImagePathLength));
+		}
+		Out.bitness = ReadExecutableBitness(Key.pid);
+		return true;
+	}
+
+	// File-backed mappings from /proc/<pid>/maps; consecutive mappings of one file form one module
+	bool EnumerateModules(const ProcessKey& Key, const std::function<void(const ProcessModuleEntry&)>& Visit) const override {
+		char Stat[1024];
+		ProcessSourceEntry Current;
+		if (!ReadProcessEntry(Key.pid, Stat, Current) || Current.creationTime != Key.creationTime) {
+			return false; // Exited, or the PID now belongs to another process
+		}
+		char Path[64];
+		std::snprintf(Path, sizeof(Path), "/proc/%u/maps", Key.pid);
+		FILE* Maps = std::fopen(Path, "re");
+		if (!Maps) {
+			return false; // Another user's process without ptrace access
+		}
+
+		std::string ModulePath;
+		ProcessModuleEntry Module;
+		const auto Flush = [&] {
+			if (!ModulePath.empty()) {
+				Module.path = ModulePath;
+				Visit(Module);
+			}
+		};
+		char* Line = nullptr;
+		size_t LineCapacity = 0;
+		ssize_t LineLength;
+		while ((LineLength = getline(&Line, &LineCapacity, Maps)) > 0) {
+			// "start-end perms offset dev inode   path", addresses in hex
+			const char* End = Line + LineLength - (Line[LineLength - 1] == '\n' ? 1 : 0);
+			std::uint64_t Start = 0, Stop = 0;
+			const char* Cursor = std::from_chars(Line, End, Start, 16).ptr;
+			if (Cursor >= End || *Cursor != '-') {
+				continue;
+			}
+			Cursor = std::from_chars(Cursor + 1, End, Stop, 16).ptr;
+			// Skip perms, offset, dev and inode; the path starts after the padding that follows them
+			for (int Field = 0; Field < 5 && Cursor < End; ++Field) {
+				Cursor = std::find_if(Cursor, End, [](char c) { return c != ' '; });
+				if (Field < 4) {
+					Cursor = std::find(Cursor, End, ' ');
+				}
+			}
+			const std::string_view MappedPath(Cursor, static_cast<size_t>(End - Cursor));
+			if (MappedPath.empty() || MappedPath.front() != '/') {
+				continue; // Anonymous memory, [heap], [stack], [vdso]; a library's .bss does not end it
+			}
+			if (MappedPath == ModulePath) {
+				Module.size = Stop - Module.base;
+				continue;
+			}
+			Flush();
+			ModulePath.assign(MappedPath);
+			Module.base = Start;
+			Module.size = Stop - Start;
+		}
+		Flush();
+		std::free(Line);
+		std::fclose(Maps);
+		return true;
+	}
+
+	std::unique_ptr<ProcessEventSource> CreateEventSource() override {
+		if (auto Netlink = std::make_unique<NetlinkProcessEventSource>(); Netlink->IsSubscribed()) {
+			return Netlink;
+		}
+		if (auto Polling = std::make_unique<ProcfsPollingEventSource>(); Polling->IsValid()) {
+			return Polling;
+		}
+		return nullptr;
+	}
+};
+
+std::unique_ptr<ProcessSource> CreatePlatformProcessSource() {
+	return std::make_unique<ProcfsProcessSource>();
+}
@@ -0,0 +1,399 @@
+#include "ProcessSource.h"
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#include <TlHelp32.h> // For process enumeration
+#include <Psapi.h>    // For GetProcessMemoryInfo
+#include <evntrace.h> // For the live process event session
+#include <evntcons.h>
+#include <tdh.h>
+#include <algorithm>
+#include <climits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "TextConversion.h"
+
+// Convert a Toolhelp32 executable name to std::wstring
+static void ToWideProcessName(const TCHAR* ExeFile, std::wstring& Out) {
+#ifdef UNICODE
+	// If UNICODE is defined, TCHAR is wchar_t.
+	// ProcessEntry.szExeFile is wchar_t[] and null-terminated.
+	// Direct assignment to std::wstring is safe and efficient.
+	Out = ExeFile;
+#else
+	// If UNICODE is not defined, TCHAR is char.
+	// ProcessEntry.szExeFile is char[] (ANSI/MBCS) and null-terminated.
+	// We need to explicitly convert it to std::wstring (wchar_t).
+	if (ExeFile[0] == '\0') {
+		Out.clear(); // Handle empty string case
+		return;
+	}
+	// Determine buffer size needed for wide string (including null terminator)
+	int requiredBufferSize = MultiByteToWideChar(CP_ACP, 0, ExeFile, -1, nullptr, 0);
+	if (requiredBufferSize <= 0) {
+		// Handle conversion error, e.g., log GetLastError()
+		Out = L"[Conversion Error]";
+		return;
+	}
+	// std::wstring needs character count, not including its own null.
+	// requiredBufferSize from MultiByteToWideChar (with -1 input length) includes the null.
+	Out.resize(static_cast<size_t>(requiredBufferSize) - 1);
+	MultiByteToWideChar(CP_ACP, 0, ExeFile, -1, Out.data(), requiredBufferSize);
+#endif
+}
+
+static std::uint64_t QueryCreationTime(HANDLE ProcessHandle) {
+	FILETIME CreationTime = {}, ExitTime = {}, KernelTime = {}, UserTime = {};
+	if (!GetProcessTimes(ProcessHandle, &CreationTime, &ExitTime, &KernelTime, &UserTime)) {
+		return 0;
+	}
+	return (static_cast<std::uint64_t>(CreationTime.dwHighDateTime) << 32) | CreationTime.dwLowDateTime;
+}
+
+// Creation time distinguishes a recycled PID from the process that used it before
+static std::uint64_t QueryProcessCreationTime(DWORD ProcessID) {
+	HANDLE ProcessHandle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, ProcessID);
+	if (!ProcessHandle) {
+		return 0; // Protected or already exited; the key falls back to the PID alone
+	}
+	const std::uint64_t Result = QueryCreationTime(ProcessHandle);
+	CloseHandle(ProcessHandle);
+	return Result;
+}
+
+static bool IsNativeSystem64Bit() {
+	SYSTEM_INFO SystemInfo = {};
+	GetNativeSystemInfo(&SystemInfo);
+	return SystemInfo.wProcessorArchitecture == PROCESSOR_ARCHITECTURE_AMD64 ||
+		SystemInfo.wProcessorArchitecture == PROCESSOR_ARCHITECTURE_ARM64;
+}
+
+// Microsoft-Windows-Kernel-Process and its WINEVENT_KEYWORD_PROCESS keyword (start/stop events)
+static constexpr GUID KernelProcessProvider = { 0x22fb2cd6, 0x0e7b, 0x422b, { 0xa0, 0xc7, 0x2f, 0xad, 0x1f, 0xd0, 0xe7, 0x16 } };
+static constexpr ULONGLONG KernelProcessKeyword = 0x10;
+static constexpr USHORT ProcessStartEventID = 1;
+static constexpr USHORT ProcessStopEventID = 2;
+// Sent by ETW to real-time consumers that fell behind and lost buffers
+static constexpr GUID RealTimeLostEventGuid = { 0x6a399ae0, 0x4bc6, 0x4de9, { 0x87, 0x0b, 0x36, 0x57, 0xf8, 0x94, 0x7e, 0x7e } };
+
+// Reads a fixed-size event field by name; false when this event version does not have it
+template <typename T>
+static bool ReadEventProperty(PEVENT_RECORD Record, const wchar_t* Name, T& Out) {
+	PROPERTY_DATA_DESCRIPTOR Descriptor = { reinterpret_cast<ULONGLONG>(Name), ULONG_MAX, 0 };
+	ULONG Size = 0;
+	if (TdhGetPropertySize(Record, 0, nullptr, 1, &Descriptor, &Size) != ERROR_SUCCESS || Size != sizeof(T)) {
+		return false;
+	}
+	return TdhGetProperty(Record, 0, nullptr, 1, &Descriptor, sizeof(T), reinterpret_cast<PBYTE>(&Out)) == ERROR_SUCCESS;
+}
+
+// Process start/stop events from a private real-time ETW session. Starting the session needs
+// administrator rights or the Performance Log Users group, which an injector usually has anyway.
+struct EtwProcessEventSource : ProcessEventSource {
+private:
+	// Queued by the ETW thread for the next WaitForEvents
+	struct QueuedEvent {
+		ProcessEventType Type;
+		ProcessID Pid;
+		std::uint64_t CreationTime;
+		ProcessID ParentPid;
+		std::uint32_t NameOffset, NameLength; // In QueuedNames
+	};
+
+	std::wstring SessionName;
+	DynamicArray<BYTE> SessionProperties; // EVENT_TRACE_PROPERTIES followed by the session name
+	TRACEHANDLE Session = 0;
+	TRACEHANDLE Trace = INVALID_PROCESSTRACE_HANDLE;
+	std::thread TraceThread; // Blocks in ProcessTrace until the session stops
+	HANDLE Signal = CreateEventW(nullptr, FALSE, FALSE, nullptr); // Set for new events and for Wake()
+	HANDLE InstanceMutex = nullptr;  // Exists while some injector owns SessionName
+
+	std::mutex QueueMutex;
+	DynamicArray<QueuedEvent> Queue;
+	std::wstring QueuedNames;
+	bool TraceEnded = false;
+
+	// Swapped with the queue by WaitForEvents, so neither side allocates once both have grown
+	DynamicArray<QueuedEvent> Delivering;
+	std::wstring DeliveringNames;
+	std::wstring ImageName;
+
+	EVENT_TRACE_PROPERTIES* Properties() { return reinterpret_cast<EVENT_TRACE_PROPERTIES*>(SessionProperties.data()); }
+
+	void ResetProperties() {
+		SessionProperties.assign(sizeof(EVENT_TRACE_PROPERTIES) + (SessionName.size() + 1) * sizeof(wchar_t), 0);
+		EVENT_TRACE_PROPERTIES* Props = Properties();
+		Props->Wnode.BufferSize = static_cast<ULONG>(SessionProperties.size());
+		Props->Wnode.Flags = WNODE_FLAG_TRACED_GUID;
+		Props->Wnode.ClientContext = 1; // QueryPerformanceCounter timestamps
+		Props->LogFileMode = EVENT_TRACE_REAL_TIME_MODE;
+		Props->LoggerNameOffset = sizeof(EVENT_TRACE_PROPERTIES);
+	}
+
+	void OnEvent(PEVENT_RECORD Record) {
+		if (IsEqualGUID(Record->EventHeader.ProviderId, RealTimeLostEventGuid)) {
+			Enqueue({ ProcessEventType::Overflow, 0, 0, 0, 0, 0 }, {});
+			return;
+		}
+		const USHORT EventID = Record->EventHeader.EventDescriptor.Id;
+		if (!IsEqualGUID(Record->EventHeader.ProviderId, KernelProcessProvider) ||
+			(EventID != ProcessStartEventID && EventID != ProcessStopEventID)) {
+			return;
+		}
+
+		QueuedEvent Event = { EventID == ProcessStartEventID ? ProcessEventType::Started : ProcessEventType::Exited, 0, 0, 0, 0, 0 };
+		ULONG Pid = 0;
+		if (!ReadEventProperty(Record, L"ProcessID", Pid)) {
+			return;
+		}
+		Event.Pid = Pid;
+		FILETIME CreateTime = {};
+		if (ReadEventProperty(Record, L"CreateTime", CreateTime)) {
+			Event.CreationTime = (static_cast<std::uint64_t>(CreateTime.dwHighDateTime) << 32) | CreateTime.dwLowDateTime;
+		}
+		if (Event.Type == ProcessEventType::Exited) {
+			Enqueue(Event, {});
+			return;
+		}
+
+		ULONG ParentPid = 0;
+		ReadEventProperty(Record, L"ParentProcessID", ParentPid);
+		Event.ParentPid = ParentPid;
+		// ImageName is an NT device path; the table wants the file name, like Toolhelp's szExeFile
+		PROPERTY_DATA_DESCRIPTOR Descriptor = { reinterpret_cast<ULONGLONG>(L"ImageName"), ULONG_MAX, 0 };
+		ULONG Size = 0;
+		std::wstring_view Name;
+		if (TdhGetPropertySize(Record, 0, nullptr, 1, &Descriptor, &Size) == ERROR_SUCCESS && Size >= sizeof(wchar_t)) {
+			ImageName.resize(Size / sizeof(wchar_t));
+			if (TdhGetProperty(Record, 0, nullptr, 1, &Descriptor, Size, reinterpret_cast<PBYTE>(ImageName.data())) == ERROR_SUCCESS) {
+				Name = std::wstring_view(ImageName.c_str());
+				Name = Name.substr(Name.find_last_of(L'\\') + 1); // npos + 1 == 0 keeps the whole name
+			}
+		}
+		Enqueue(Event, Name);
+	}
+
+	void Enqueue(QueuedEvent Event, std::wstring_view Name) {
+		{
+			std::lock_guard Lock(QueueMutex);
+			Event.NameOffset = static_cast<std::uint32_t>(QueuedNames.size());
+			Event.NameLength = static_cast<std::uint32_t>(Name.size());
+			QueuedNames.append(Name);
+			Queue.push_back(Event);
+		}
+		SetEvent(Signal);
+	}
+
+	static void WINAPI EventRecordCallback(PEVENT_RECORD Record) {
+		static_cast<EtwProcessEventSource*>(Record->UserContext)->OnEvent(Record);
+	}
+
+public:
+	EtwProcessEventSource() {
+		// Real-time sessions come from a small system-wide pool, so the name is fixed: a session leaked by a
+		// crashed injector is found and stopped below instead of piling up. The named mutex tells a live
+		// second instance apart, because the kernel closes a crashed owner's handle and the name goes with it.
+		SessionName = L"ShadowBindProcessEvents";
+		InstanceMutex = CreateMutexW(nullptr, FALSE, L"Global\\ShadowBindProcessEvents");
+		if (InstanceMutex && GetLastError() == ERROR_ALREADY_EXISTS) {
+			CloseHandle(InstanceMutex); // Another injector owns the session; holding its name would outlive that owner
+			InstanceMutex = nullptr;
+		}
+		if (!InstanceMutex || !Signal) {
+			return;
+		}
+		ResetProperties();
+		ULONG Status = StartTraceW(&Session, SessionName.c_str(), Properties());
+		if (Status == ERROR_ALREADY_EXISTS) {
+			// We hold the name, so this session was leaked by an injector that crashed
+			ControlTraceW(0, SessionName.c_str(), Properties(), EVENT_TRACE_CONTROL_STOP);
+			ResetProperties();
+			Status = StartTraceW(&Session, SessionName.c_str(), Properties());
+		}
+		if (Status != ERROR_SUCCESS) {
+			Session = 0; // Typically ERROR_ACCESS_DENIED when not elevated
+			return;
+		}
+		if (EnableTraceEx2(Session, &KernelProcessProvider, EVENT_CONTROL_CODE_ENABLE_PROVIDER, TRACE_LEVEL_INFORMATION,
+			KernelProcessKeyword, 0, 0, nullptr) != ERROR_SUCCESS) {
+			return;
+		}
+
+		EVENT_TRACE_LOGFILEW LogFile = {};
+		LogFile.LoggerName = SessionName.data();
+		LogFile.ProcessTraceMode = PROCESS_TRACE_MODE_REAL_TIME | PROCESS_TRACE_MODE_EVENT_RECORD;
+		LogFile.EventRecordCallback = &EtwProcessEventSource::EventRecordCallback;
+		LogFile.Context = this;
+		Trace = OpenTraceW(&LogFile);
+		if (Trace == INVALID_PROCESSTRACE_HANDLE) {
+			return;
+		}
+		TraceThread = std::thread([this] {
+			ProcessTrace(&Trace, 1, nullptr, nullptr);
+			{
+				std::lock_guard Lock(QueueMutex);
+				TraceEnded = true;
+			}
+			SetEvent(Signal);
+		});
+	}
+
+	~EtwProcessEventSource() override {
+		if (Session) {
+			ControlTraceW(Session, nullptr, Properties(), EVENT_TRACE_CONTROL_STOP);
+		}
+		if (Trace != INVALID_PROCESSTRACE_HANDLE) {
+			CloseTrace(Trace); // Makes ProcessTrace return once the remaining buffers are delivered
+		}
+		if (TraceThread.joinable()) {
+			TraceThread.join();
+		}
+		if (Signal) {
+			CloseHandle(Signal);
+		}
+		if (InstanceMutex) {
+			CloseHandle(InstanceMutex); // After the session stopped, so the next owner never meets it running
+		}
+	}
+
+	bool IsSubscribed() const { return TraceThread.joinable(); }
+
+	const char* Name() const override { return "ETW"; }
+
+	bool WaitForEvents(std::chrono::milliseconds Timeout, const std::function<void(const ProcessEvent&)>& Visit) override {
+		const DWORD WaitTimeout = Timeout.count() >= INFINITE ? INFINITE : static_cast<DWORD>(std::max<std::chrono::milliseconds::rep>(Timeout.count(), 0));
+		WaitForSingleObject(Signal, WaitTimeout);
+
+		bool Ended;
+		{
+			std::lock_guard Lock(QueueMutex);
+			std::swap(Queue, Delivering);
+			std::swap(QueuedNames, DeliveringNames);
+			Ended = TraceEnded;
+		}
+		for (const QueuedEvent& Queued : Delivering) {
+			ProcessEvent Event;
+			Event.type = Queued.Type;
+			Event.process.pid = Queued.Pid;
+			Event.process.creationTime = Queued.CreationTime;
+			Event.process.parentPid = Queued.ParentPid;
+			Event.process.wideName = std::wstring_view(DeliveringNames.data() + Queued.NameOffset, Queued.NameLength);
+			Visit(Event);
+		}
+		Delivering.clear();
+		DeliveringNames.clear();
+		return !Ended;
+	}
+
+	void Wake() override { SetEvent(Signal); }
+};
+
+struct ToolhelpProcessSource : ProcessSource {
+private:
+	std::wstring NameBuffer; // Reused across entries, no allocation once it has grown
+
+public:
+	bool Enumerate(const std::function<void(const ProcessSourceEntry&)>& Visit) override {
+		HANDLE SnapshotHandle = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+		if (SnapshotHandle == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+
+		PROCESSENTRY32 ProcessEntry = { sizeof(ProcessEntry) }; // szExeFile is TCHAR
+		if (Process32First(SnapshotHandle, &ProcessEntry)) {
+			do {
+				ToWideProcessName(ProcessEntry.szExeFile, NameBuffer);
+				ProcessSourceEntry Entry;
+				Entry.pid = ProcessEntry.th32ProcessID;
+				Entry.creationTime = QueryProcessCreationTime(ProcessEntry.th32ProcessID);
+				Entry.parentPid = ProcessEntry.th32ParentProcessID;
+				Entry.wideName = NameBuffer;
+				Visit(Entry);
+			} while (Process32Next(SnapshotHandle, &ProcessEntry));
+		}
+		CloseHandle(SnapshotHandle);
+		return true;
+	}
+
+	bool QueryMetadata(const ProcessKey& Key, ProcessMetadata& Out) const override {
+		static const bool NativeSystem64Bit = IsNativeSystem64Bit();
+
+		HANDLE ProcessHandle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, Key.pid);
+		if (!ProcessHandle) {
+			return false;
+		}
+		if (Key.creationTime != 0 && QueryCreationTime(ProcessHandle) != Key.creationTime) {
+			CloseHandle(ProcessHandle); // The PID now belongs to another process
+			return false;
+		}
+
+		WCHAR ImagePath[MAX_PATH * 4];
+		DWORD ImagePathLength = static_cast<DWORD>(std::size(ImagePath));
+		if (QueryFullProcessImageNameW(ProcessHandle, 0, ImagePath, &ImagePathLength)) {
+			Out.imagePath = Utf8FromWide(std::wstring_view(ImagePath, ImagePathLength));
+		}
+
+		BOOL Wow64 = FALSE;
+		if (IsWow64Process(ProcessHandle, &Wow64)) {
+			Out.bitness = (Wow64 || !NativeSystem64Bit) ? 32 : 64;
+		}
+
+		DWORD SessionID = 0;
+		if (ProcessIdToSessionId(Key.pid, &SessionID)) {
+			Out.sessionId = SessionID;
+		}
+
+		PROCESS_MEMORY_COUNTERS Counters = { sizeof(Counters) };
+		if (GetProcessMemoryInfo(ProcessHandle, &Counters, sizeof(Counters))) {
+			Out.workingSetBytes = Counters.WorkingSetSize;
+		}
+
+		CloseHandle(ProcessHandle);
+		return true;
+	}
+
+	bool EnumerateModules(const ProcessKey& Key, const std::function<void(const ProcessModuleEntry&)>& Visit) const override {
+		if (Key.creationTime != 0 && QueryProcessCreationTime(Key.pid) != Key.creationTime) {
+			return false; // The PID now belongs to another process
+		}
+		// SNAPMODULE32 adds the 32-bit modules of a WOW64 target. The snapshot fails with ERROR_BAD_LENGTH
+		// while the target is loading or unloading a module; retrying is the documented remedy.
+		HANDLE SnapshotHandle = INVALID_HANDLE_VALUE;
+		for (int Attempt = 0; Attempt < 5; ++Attempt) {
+			SnapshotHandle = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, Key.pid);
+			if (SnapshotHandle != INVALID_HANDLE_VALUE || GetLastError() != ERROR_BAD_LENGTH) {
+				break;
+			}
+		}
+		if (SnapshotHandle == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+
+		std::string Path;
+		MODULEENTRY32W ModuleEntry = { sizeof(ModuleEntry) };
+		if (Module32FirstW(SnapshotHandle, &ModuleEntry)) {
+			do {
+				Path.clear();
+				AppendUtf8FromWide(ModuleEntry.szExePath, Path);
+				ProcessModuleEntry Entry;
+				Entry.base = reinterpret_cast<std::uintptr_t>(ModuleEntry.modBaseAddr);
+				Entry.size = ModuleEntry.modBaseSize;
+				Entry.path = Path;
+				Visit(Entry);
+			} while (Module32NextW(SnapshotHandle, &ModuleEntry));
+		}
+		CloseHandle(SnapshotHandle);
+		return true;
+	}
+
+	std::unique_ptr<ProcessEventSource> CreateEventSource() override {
+		auto Etw = std::make_unique<EtwProcessEventSource>();
+		return Etw->IsSubscribed() ? std::move(Etw) : nullptr; // Not elevated or another injector owns the session: refresh on demand
+	}
+};
+
+std::unique_ptr<ProcessSource> CreatePlatformProcessSource() {
+	return std::make_unique<ToolhelpProcessSource>();
+}
@@ -0,0 +1,197 @@
+#include "ProcessTable.h"
+#include "TextConversion.h"
+#include <algorithm>
+#include <charconv>
+
+static std::uint32_t HashName(std::string_view Name) {
+	std::uint32_t Hash = 2166136261u; // FNV-1a; names are short
+	for (char c : Name) {
+		Hash = (Hash ^ static_cast<unsigned char>(c)) * 16777619u;
+	}
+	return Hash;
+}
+
+static ArenaSpan AppendToArena(std::string& Arena, std::string_view Text) {
+	const ArenaSpan Span = { static_cast<std::uint32_t>(Arena.size()), static_cast<std::uint32_t>(Text.size()) };
+	Arena.append(Text);
+	return Span;
+}
+
+static ArenaSpan AppendToArena(std::wstring& Arena, std::wstring_view Text) {
+	const ArenaSpan Span = { static_cast<std::uint32_t>(Arena.size()), static_cast<std::uint32_t>(Text.size()) };
+	Arena.append(Text);
+	return Span;
+}
+
+// Finds or adds a name in Building. WideName may be empty, in which case it is converted from UTF-8.
+std::uint32_t ProcessTable::InternName(std::string_view Utf8Name, std::wstring_view WideName) {
+	const size_t Mask = NameSlots.size() - 1;
+	size_t Slot = HashName(Utf8Name) & Mask;
+	for (; NameSlots[Slot] != 0; Slot = (Slot + 1) & Mask) {
+		const ArenaSpan& Existing = Building.NamesUtf8[NameSlots[Slot] - 1];
+		if (std::string_view(Building.Utf8Arena.data() + Existing.Offset, Existing.Length) == Utf8Name) {
+			return NameSlots[Slot] - 1;
+		}
+	}
+
+	const std::uint32_t NameId = static_cast<std::uint32_t>(Building.NamesUtf8.size());
+	Building.NamesUtf8.push_back(AppendToArena(Building.Utf8Arena, Utf8Name));
+	if (!WideName.empty() || Utf8Name.empty()) {
+		Building.NamesWide.push_back(AppendToArena(Building.WideArena, WideName));
+	} else {
+		const std::uint32_t Offset = static_cast<std::uint32_t>(Building.WideArena.size());
+		AppendWideFromUtf8(Utf8Name, Building.WideArena);
+		Building.NamesWide.push_back({ Offset, static_cast<std::uint32_t>(Building.WideArena.size() - Offset) });
+	}
+	NameSlots[Slot] = NameId + 1;
+	return NameId;
+}
+
+// Appends one row to Building with its "Name (PID)" label; Utf8Name is the text of NameId
+void ProcessTable::AppendRow(const ProcessKey& Key, ProcessID ParentPid, std::uint32_t NameId, std::string_view Utf8Name) {
+	Building.Pids.push_back(Key.pid);
+	Building.CreationTimes.push_back(Key.creationTime);
+	Building.ParentPids.push_back(ParentPid);
+	Building.NameIds.push_back(NameId);
+
+	char Label[32];
+	char* End = std::to_chars(Label, Label + sizeof(Label), Key.pid).ptr;
+	const std::uint32_t Offset = static_cast<std::uint32_t>(Building.Utf8Arena.size());
+	Building.Utf8Arena.append(Utf8Name);
+	Building.Utf8Arena += " (";
+	Building.Utf8Arena.append(Label, End);
+	Building.Utf8Arena += ')';
+	Building.Labels.push_back({ Offset, static_cast<std::uint32_t>(Building.Utf8Arena.size() - Offset) });
+	Building.Utf8Arena += '\0';
+}
+
+bool ProcessTable::RefreshProcessIDList(ProcessSource& Source) {
+	RowLookup.Build(Rows.Pids);
+	RowSeen.assign(Rows.Size(), 0);
+	Added.clear();
+	AddedUtf8Names.clear();
+	AddedWideNames.clear();
+	const bool Enumerated = Source.Enumerate([&](const ProcessSourceEntry& Entry) {
+		const int Row = RowLookup.Find(Entry.pid, Rows.Pids);
+		if (Row >= 0 && Rows.CreationTimes[Row] == Entry.creationTime) {
+			RowSeen[Row] = 1;
+			return;
+		}
+		AddProcess(Entry); // New process, or a recycled PID whose old instance is dropped below as unseen
+	});
+	if (!Enumerated) {
+		return false; // Keep the previous table rather than emptying it
+	}
+	const bool AnyRemoved = std::find(RowSeen.begin(), RowSeen.end(), 0) != RowSeen.end();
+	if (!AnyRemoved && Added.empty()) {
+		return false;
+	}
+	Rebuild();
+	return true;
+}
+
+void ProcessTable::AddProcess(const ProcessSourceEntry& Entry) {
+	AddedProcess Process = { { Entry.pid, Entry.creationTime }, Entry.parentPid, {}, !Entry.wideName.empty() };
+	Process.Name = Process.WideName ? AppendToArena(AddedWideNames, Entry.wideName) : AppendToArena(AddedUtf8Names, Entry.utf8Name);
+	Added.push_back(Process);
+}
+
+void ProcessTable::BeginEventBatch() {
+	RowLookup.Build(Rows.Pids);
+	RowSeen.assign(Rows.Size(), 1); // Rows are kept unless an event drops them
+	Added.clear();
+	AddedUtf8Names.clear();
+	AddedWideNames.clear();
+}
+
+void ProcessTable::ApplyEvent(const ProcessEvent& Event) {
+	const ProcessSourceEntry& Entry = Event.process;
+	// 0 is an unknown creation time on either side (Toolhelp rows whose process could not be opened), so it matches any instance
+	const auto SameInstance = [&](std::uint64_t CreationTime) {
+		return Entry.creationTime == 0 || CreationTime == 0 || CreationTime == Entry.creationTime;
+	};
+	// A process that started earlier in this batch is replaced or dropped; its arena text is simply left behind
+	const auto Pending = std::find_if(Added.begin(), Added.end(), [&](const AddedProcess& Process) { return Process.Key.pid == Entry.pid; });
+	if (Pending != Added.end() && (Event.type == ProcessEventType::Started || SameInstance(Pending->Key.creationTime))) {
+		Added.erase(Pending);
+	}
+
+	const int Row = RowLookup.Find(Entry.pid, Rows.Pids);
+	if (Event.type == ProcessEventType::Exited) {
+		if (Row >= 0 && SameInstance(Rows.CreationTimes[Row])) {
+			RowSeen[Row] = 0;
+		}
+		return;
+	}
+	if (Event.type != ProcessEventType::Started) {
+		return;
+	}
+	if (Row >= 0 && RowSeen[Row] && Rows.CreationTimes[Row] == Entry.creationTime && Rows.ParentPids[Row] == Entry.parentPid &&
+		(Entry.wideName.empty() ? Rows.NameUtf8(Row) == Entry.utf8Name : Rows.Name(Row) == Entry.wideName)) {
+		return; // Already known, e.g. reported by both the subscription and the first enumeration
+	}
+	if (Row >= 0) {
+		RowSeen[Row] = 0; // Renamed by exec, or a recycled PID
+	}
+	AddProcess(Entry);
+}
+
+bool ProcessTable::EndEventBatch() {
+	const bool AnyRemoved = std::find(RowSeen.begin(), RowSeen.end(), 0) != RowSeen.end();
+	if (!AnyRemoved && Added.empty()) {
+		return false;
+	}
+	Rebuild();
+	return true;
+}
+
+// Rebuilds into the back buffer from the rows marked in RowSeen and the processes in Added:
+// survivors first (spans copied, no conversions), then the new rows
+void ProcessTable::Rebuild() {
+	Building.Clear();
+	NameRemap.assign(Rows.NameCount(), 0);
+	size_t NameSlotCount = 16;
+	while (NameSlotCount < (Rows.NameCount() + Added.size()) * 2) {
+		NameSlotCount *= 2;
+	}
+	NameSlots.assign(NameSlotCount, 0);
+
+	for (size_t Row = 0; Row < Rows.Size(); ++Row) {
+		if (!RowSeen[Row]) {
+			continue;
+		}
+		std::uint32_t& Remapped = NameRemap[Rows.NameIds[Row]];
+		if (Remapped == 0) {
+			Remapped = InternName(Rows.NameUtf8(Row), Rows.Name(Row)) + 1;
+		}
+		AppendRow(Rows.Key(Row), Rows.ParentPids[Row], Remapped - 1, Rows.NameUtf8(Row));
+	}
+	for (const AddedProcess& Process : Added) {
+		std::string_view Utf8Name;
+		std::wstring_view WideName;
+		if (Process.WideName) {
+			WideName = std::wstring_view(AddedWideNames.data() + Process.Name.Offset, Process.Name.Length);
+			ConvertedName.clear();
+			AppendUtf8FromWide(WideName, ConvertedName);
+			Utf8Name = ConvertedName;
+		} else {
+			Utf8Name = std::string_view(AddedUtf8Names.data() + Process.Name.Offset, Process.Name.Length);
+		}
+		AppendRow(Process.Key, Process.ParentPid, InternName(Utf8Name, WideName), Utf8Name);
+	}
+
+	std::swap(Rows, Building);
+}
+
+std::shared_ptr<ProcessSnapshot> ProcessTable::MakeSnapshot(unsigned long long Version) const {
+	auto Snapshot = std::make_shared<ProcessSnapshot>();
+	Snapshot->Version = Version;
+	Snapshot->Processes = Rows; // One allocation per column and arena
+	Snapshot->RowByPID.Build(Snapshot->Processes.Pids);
+	Snapshot->SearchIndex.Reserve(Rows.Size(), Rows.Utf8Arena.size());
+	for (size_t Row = 0; Row < Rows.Size(); ++Row) {
+		Snapshot->SearchIndex.Add(Rows.LabelView(Row));
+	}
+	Snapshot->SearchIndex.Finish();
+	return Snapshot;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "ProcessInfo.h"
+#include "ProcessSource.h"
+#include <memory>
+
+// The incremental process model. A refresh only converts names and builds labels for processes
+// it has not seen; survivors are copied span by span from the previous columns, keeping their order,
+// and new processes are appended. All buffers are reused, so a steady-state refresh does not allocate.
+struct ProcessTable {
+private:
+	// One process from the current enumeration that is not in the table yet
+	struct AddedProcess {
+		ProcessKey Key;
+		ProcessID ParentPid;
+		ArenaSpan Name; // In AddedUtf8Names or AddedWideNames
+		bool WideName;
+	};
+
+	ProcessColumns Rows;     // In order of discovery
+	ProcessColumns Building; // Back buffer the next changed refresh writes into, then swapped with Rows
+
+	// Scratch reused by every refresh
+	ProcessRowLookup RowLookup;              // Over Rows.Pids, for matching enumerated processes
+	DynamicArray<std::uint8_t> RowSeen;      // Per row of Rows
+	DynamicArray<AddedProcess> Added;
+	std::string AddedUtf8Names;
+	std::wstring AddedWideNames;
+	DynamicArray<std::uint32_t> NameRemap;   // Rows NameId -> Building NameId + 1, 0 = not copied yet
+	DynamicArray<std::uint32_t> NameSlots;   // Open addressing over Building's names, NameId + 1
+	std::string ConvertedName;
+
+	std::uint32_t InternName(std::string_view Utf8Name, std::wstring_view WideName);
+	void AppendRow(const ProcessKey& Key, ProcessID ParentPid, std::uint32_t NameId, std::string_view Utf8Name);
+	void AddProcess(const ProcessSourceEntry& Entry);
+	void Rebuild();
+
+public:
+	// Returns true when rows were added or removed
+	bool RefreshProcessIDList(ProcessSource& Source);
+
+	// Event-driven updates: events between Begin and End are applied with a single rebuild.
+	// End returns true when rows were added, removed or renamed.
+	void BeginEventBatch();
+	void ApplyEvent(const ProcessEvent& Event);
+	bool EndEventBatch();
+
+	// Copies the table into an immutable snapshot with its lookup and search indexes
+	std::shared_ptr<ProcessSnapshot> MakeSnapshot(unsigned long long Version) const;
+
+	const ProcessColumns& Processes() const { return Rows; }
+};
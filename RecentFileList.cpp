@@ -0,0 +1,69 @@
+#include "RecentFileList.h"
+#include <algorithm>
+#include <fstream>
+#include <system_error>
+
+RecentFileList::RecentFileList(std::filesystem::path StorePath, size_t Capacity)
+	: StorePath(std::move(StorePath)), Capacity(Capacity) {}
+
+void RecentFileList::Load() {
+	Loaded = true;
+	std::ifstream Store(StorePath, std::ios::binary);
+	std::string Line;
+	while (Paths.size() < Capacity && std::getline(Store, Line)) {
+		if (!Line.empty() && Line.back() == '\r') {
+			Line.pop_back(); // Edited by hand on Windows
+		}
+		if (!Line.empty() && std::find(Paths.begin(), Paths.end(), Line) == Paths.end()) {
+			Paths.push_back(Line);
+		}
+	}
+}
+
+// Written to a temporary file and renamed over the store, so a crash never leaves half a list
+void RecentFileList::Save() const {
+	std::filesystem::path TemporaryPath = StorePath;
+	TemporaryPath += ".tmp";
+	{
+		std::ofstream Store(TemporaryPath, std::ios::binary | std::ios::trunc);
+		for (const std::string& Path : Paths) {
+			Store << Path << '\n';
+		}
+		if (!Store) {
+			return;
+		}
+	}
+	std::error_code Error;
+	std::filesystem::rename(TemporaryPath, StorePath, Error);
+}
+
+const DynamicArray<std::string>& RecentFileList::Items() {
+	if (!Loaded) {
+		Load();
+	}
+	return Paths;
+}
+
+void RecentFileList::Add(std::string_view Path) {
+	if (Path.empty() || Path.find('\n') != std::string_view::npos) {
+		return;
+	}
+	Items();
+	const auto Existing = std::find(Paths.begin(), Paths.end(), Path);
+	if (Existing != Paths.end() && Existing == Paths.begin()) {
+		return; // Already the newest; nothing to write
+	}
+	if (Existing != Paths.end()) {
+		Paths.erase(Existing);
+	} else if (Paths.size() == Capacity) {
+		Paths.pop_back();
+	}
+	Paths.insert(Paths.begin(), std::string(Path));
+	Save();
+}
+
+void RecentFileList::Clear() {
+	Paths.clear();
+	Loaded = true;
+	Save();
+}
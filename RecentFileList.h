@@ -0,0 +1,27 @@
+#pragma once
+#include "ProcessInfo.h"
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+// Most recently used file paths (UTF-8), newest first, stored one per line in a small text file.
+// The file is only read the first time the list is used, so it costs nothing at startup. Render thread only.
+struct RecentFileList {
+private:
+	std::filesystem::path StorePath;
+	size_t Capacity;
+	DynamicArray<std::string> Paths;
+	bool Loaded = false;
+
+	void Load();
+	void Save() const;
+
+public:
+	RecentFileList(std::filesystem::path StorePath, size_t Capacity = 10);
+
+	const DynamicArray<std::string>& Items();
+	// Moves Path to the front, adding it if new, and writes the store
+	void Add(std::string_view Path);
+	void Clear();
+};
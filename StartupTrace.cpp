@@ -0,0 +1,39 @@
+#include "StartupTrace.h"
+#include <algorithm>
+#include <cstdio>
+
+StartupTrace& StartupTrace::Global() {
+	static StartupTrace Trace;
+	return Trace;
+}
+
+void StartupTrace::Mark(std::string_view Name) {
+	std::lock_guard Lock(StepsMutex); // Taken before reading the clock so steps stay in time order
+	const double Milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+	RecordedSteps.push_back({ std::string(Name), Milliseconds });
+}
+
+void StartupTrace::MarkOnce(std::string_view Name) {
+	std::lock_guard Lock(StepsMutex);
+	const double Milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+	if (std::none_of(RecordedSteps.begin(), RecordedSteps.end(), [&](const Step& Recorded) { return Recorded.Name == Name; })) {
+		RecordedSteps.push_back({ std::string(Name), Milliseconds });
+	}
+}
+
+std::vector<StartupTrace::Step> StartupTrace::Steps() const {
+	std::lock_guard Lock(StepsMutex);
+	return RecordedSteps;
+}
+
+std::string StartupTrace::Format() const {
+	std::string Text;
+	double Previous = 0.0;
+	for (const Step& Recorded : Steps()) {
+		char Line[160];
+		std::snprintf(Line, sizeof(Line), "%9.2f ms  (+%8.2f)  %s\n", Recorded.Milliseconds, Recorded.Milliseconds - Previous, Recorded.Name.c_str());
+		Text += Line;
+		Previous = Recorded.Milliseconds;
+	}
+	return Text;
+}
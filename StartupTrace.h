@@ -0,0 +1,33 @@
+#pragma once
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Timestamps for each initialization step, relative to the first use of the trace (the top of WinMain).
+// Steps that finish on worker threads, such as the first process snapshot, are recorded as they arrive.
+struct StartupTrace {
+	struct Step {
+		std::string Name;
+		double Milliseconds = 0.0; // Since the trace started
+	};
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	const Clock::time_point Start = Clock::now();
+	mutable std::mutex StepsMutex;
+	std::vector<Step> RecordedSteps;
+
+public:
+	static StartupTrace& Global();
+
+	// Thread-safe. MarkOnce ignores names already recorded, for events checked every frame.
+	void Mark(std::string_view Name);
+	void MarkOnce(std::string_view Name);
+
+	std::vector<Step> Steps() const;
+	// One line per step: offset from the start and time since the previous step
+	std::string Format() const;
+};
@@ -0,0 +1,123 @@
+#include "PEImage.h"
+#include <cstring>
+#include <string>
+
+// Writes Value little-endian at Offset, growing Bytes as needed
+static void Put(DynamicArray<std::uint8_t>& Bytes, size_t Offset, std::uint64_t Value, size_t Size) {
+	if (Bytes.size() < Offset + Size) {
+		Bytes.resize(Offset + Size);
+	}
+	for (size_t Index = 0; Index < Size; ++Index) {
+		Bytes[Offset + Index] = static_cast<std::uint8_t>(Value >> (8 * Index));
+	}
+}
+
+static std::uint32_t AlignTo8(size_t Offset) {
+	return static_cast<std::uint32_t>((Offset + 7) & ~size_t(7));
+}
+
+SyntheticPEImage MakeSyntheticPEImage(const SyntheticPEOptions& Options) {
+	// Headers in the first 0x400 bytes, then one section holding every table and string
+	constexpr std::uint32_t HeadersSize = 0x400, SectionRva = 0x1000;
+	const std::uint32_t ThunkSize = Options.is64Bit ? 8 : 4;
+	const std::uint64_t OrdinalFlag = Options.is64Bit ? 0x8000000000000000ull : 0x80000000ull;
+	DynamicArray<std::uint8_t> Section;
+	const auto AppendString = [&](const std::string& Text) {
+		const std::uint32_t Rva = SectionRva + static_cast<std::uint32_t>(Section.size());
+		Section.insert(Section.end(), Text.begin(), Text.end());
+		Section.push_back(0);
+		return Rva;
+	};
+
+	// Export directory (40 bytes), then the function, name and ordinal arrays, then the names
+	const std::uint32_t ExportCount = Options.exportCount;
+	const std::uint32_t Functions = 40, Names = Functions + 4 * ExportCount, Ordinals = Names + 4 * ExportCount;
+	Section.resize(Ordinals + 2 * ExportCount);
+	Put(Section, 20, ExportCount, 4);
+	Put(Section, 24, ExportCount, 4);
+	Put(Section, 28, SectionRva + Functions, 4);
+	Put(Section, 32, SectionRva + Names, 4);
+	Put(Section, 36, SectionRva + Ordinals, 4);
+	std::uint32_t FirstExportName = 0;
+	for (std::uint32_t Index = 0; Index < ExportCount; ++Index) {
+		Put(Section, Functions + 4 * Index, SectionRva, 4);
+		Put(Section, Ordinals + 2 * Index, Index, 2);
+		const std::uint32_t NameRva = AppendString("Export_" + std::to_string(Index));
+		Put(Section, Names + 4 * Index, NameRva, 4);
+		FirstExportName = Index == 0 ? NameRva - SectionRva : FirstExportName;
+	}
+	const std::uint32_t ExportsSize = static_cast<std::uint32_t>(Section.size());
+
+	// A zero-terminated descriptor array (20 bytes per import, 32 per delay import), then per module
+	// a lookup table of imports by ordinal and the module name
+	const auto AppendImports = [&](std::uint32_t ModuleCount, bool Delayed, const char* Prefix) {
+		const std::uint32_t DescriptorSize = Delayed ? 32 : 20;
+		const std::uint32_t Descriptors = AlignTo8(Section.size());
+		Section.resize(Descriptors + DescriptorSize * (ModuleCount + 1));
+		for (std::uint32_t Module = 0; Module < ModuleCount; ++Module) {
+			const std::uint32_t Lookup = AlignTo8(Section.size());
+			for (std::uint32_t Function = 0; Function < Options.functionsPerModule; ++Function) {
+				Put(Section, Lookup + ThunkSize * Function, OrdinalFlag | (Function + 1), ThunkSize);
+			}
+			Put(Section, Lookup + ThunkSize * Options.functionsPerModule, 0, ThunkSize);
+			const std::uint32_t Descriptor = Descriptors + DescriptorSize * Module;
+			const std::uint32_t NameRva = AppendString(Prefix + std::to_string(Module) + ".dll");
+			if (Delayed) {
+				Put(Section, Descriptor, 1, 4);                       // Attributes: RVA-based
+				Put(Section, Descriptor + 4, NameRva, 4);
+				Put(Section, Descriptor + 12, SectionRva + Lookup, 4); // ImportAddressTableRVA
+				Put(Section, Descriptor + 16, SectionRva + Lookup, 4); // ImportNameTableRVA
+			} else {
+				Put(Section, Descriptor, SectionRva + Lookup, 4);      // OriginalFirstThunk
+				Put(Section, Descriptor + 12, NameRva, 4);
+				Put(Section, Descriptor + 16, SectionRva + Lookup, 4); // FirstThunk
+			}
+		}
+		return Descriptors;
+	};
+	const std::uint32_t Imports = Options.importModules ? AppendImports(Options.importModules, false, "module_") : 0;
+	const std::uint32_t DelayImports = Options.delayImportModules ? AppendImports(Options.delayImportModules, true, "delayed_") : 0;
+
+	// DOS header, PE signature, IMAGE_FILE_HEADER, then IMAGE_OPTIONAL_HEADER32/64 and one section header
+	SyntheticPEImage Result;
+	DynamicArray<std::uint8_t>& Image = Result.bytes;
+	Image.resize(HeadersSize);
+	Put(Image, 0, 0x5A4D, 2);          // MZ
+	Put(Image, 0x3C, 0x40, 4);         // e_lfanew
+	Put(Image, 0x40, 0x00004550, 4);   // PE\0\0
+	Put(Image, 0x44, Options.is64Bit ? 0x8664 : 0x014C, 2);
+	Put(Image, 0x46, 1, 2);            // NumberOfSections
+	const std::uint32_t OptionalSize = Options.is64Bit ? 240 : 224;
+	Put(Image, 0x54, OptionalSize, 2);
+	Put(Image, 0x56, Options.is64Bit ? 0x2022 : 0x2102, 2); // DLL | EXECUTABLE_IMAGE | LARGE_ADDRESS_AWARE or 32BIT_MACHINE
+	const size_t Optional = 0x58;
+	Put(Image, Optional, Options.is64Bit ? 0x20B : 0x10B, 2);
+	Put(Image, Optional + 60, HeadersSize, 4);
+	Put(Image, Optional + 68, 2, 2);   // Windows GUI
+	const size_t DirectoryCount = Optional + (Options.is64Bit ? 108 : 92);
+	Put(Image, DirectoryCount, 16, 4); // NumberOfRvaAndSizes
+	const auto PutDirectory = [&](std::uint32_t Index, std::uint32_t Rva, std::uint32_t Size) {
+		Put(Image, DirectoryCount + 4 + 8 * Index, Rva, 4);
+		Put(Image, DirectoryCount + 8 + 8 * Index, Size, 4);
+	};
+	PutDirectory(0, SectionRva, ExportsSize);
+	if (Options.importModules) {
+		PutDirectory(1, SectionRva + Imports, 20 * (Options.importModules + 1));
+	}
+	if (Options.delayImportModules) {
+		PutDirectory(13, SectionRva + DelayImports, 32 * (Options.delayImportModules + 1));
+	}
+	const size_t SectionHeader = Optional + OptionalSize;
+	std::memcpy(Image.data() + SectionHeader, ".rdata", 6);
+	Put(Image, SectionHeader + 8, Section.size(), 4);
+	Put(Image, SectionHeader + 12, SectionRva, 4);
+	Put(Image, SectionHeader + 16, Section.size(), 4);
+	Put(Image, SectionHeader + 20, HeadersSize, 4);
+	Image.insert(Image.end(), Section.begin(), Section.end());
+
+	Result.machineOffset = 0x44;
+	Result.sectionTableEnd = SectionHeader + 40;
+	Result.exportDirectoryOffset = HeadersSize;
+	Result.firstExportNameOffset = HeadersSize + FirstExportName;
+	return Result;
+}
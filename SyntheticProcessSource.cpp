@@ -0,0 +1,83 @@
+#include "ProcessSource.h"
+#include <random>
+#include <string>
+
+static const char* const SyntheticNames[] = {
+	"svchost.exe", "RuntimeBroker.exe", "chrome.exe", "msedge.exe", "explorer.exe", "conhost.exe",
+	"dllhost.exe", "SearchHost.exe", "Code.exe", "devenv.exe", "MsMpEng.exe", "WmiPrvSE.exe",
+	"backgroundTaskHost.exe", "ShellExperienceHost.exe", "sihost.exe", "taskhostw.exe",
+};
+
+struct SyntheticProcessSource : ProcessSource {
+private:
+	struct SyntheticProcess {
+		ProcessID pid;
+		std::uint64_t creationTime;
+		ProcessID parentPid;
+		std::string name;
+	};
+
+	DynamicArray<SyntheticProcess> Processes;
+	std::mt19937 Random;
+	double ChurnPerRefresh;
+	ProcessID NextPID = 4;
+	std::uint64_t Clock = 1;
+	bool FirstEnumeration = true;
+
+	SyntheticProcess MakeProcess() {
+		SyntheticProcess Process;
+		Process.pid = NextPID;
+		NextPID += 4; // Windows PIDs are multiples of four
+		Process.creationTime = Clock++;
+		Process.parentPid = Process.pid > 4 ? 4 + 4 * static_cast<ProcessID>(Random() % ((Process.pid - 4) / 4)) : 0;
+		// Roughly one in four names is unique, the rest repeat like svchost.exe does
+		if (Random() % 4 == 0) {
+			Process.name = "worker_" + std::to_string(Random() % 5000) + ".exe";
+		} else {
+			Process.name = SyntheticNames[Random() % std::size(SyntheticNames)];
+		}
+		return Process;
+	}
+
+public:
+	SyntheticProcessSource(size_t ProcessCount, unsigned Seed, double ChurnPerRefresh)
+		: Random(Seed), ChurnPerRefresh(ChurnPerRefresh) {
+		Processes.reserve(ProcessCount);
+		for (size_t Index = 0; Index < ProcessCount; ++Index) {
+			Processes.push_back(MakeProcess());
+		}
+	}
+
+	bool Enumerate(const std::function<void(const ProcessSourceEntry&)>& Visit) override {
+		if (!FirstEnumeration && !Processes.empty()) {
+			const size_t Replaced = static_cast<size_t>(static_cast<double>(Processes.size()) * ChurnPerRefresh);
+			for (size_t Count = 0; Count < Replaced; ++Count) {
+				Processes[Random() % Processes.size()] = MakeProcess();
+			}
+		}
+		FirstEnumeration = false;
+
+		for (const SyntheticProcess& Process : Processes) {
+			ProcessSourceEntry Entry;
+			Entry.pid = Process.pid;
+			Entry.creationTime = Process.creationTime;
+			Entry.parentPid = Process.parentPid;
+			Entry.utf8Name = Process.name;
+			Visit(Entry);
+		}
+		return true;
+	}
+
+	// Derived from the key alone so concurrent calls never touch the mutable process list
+	bool QueryMetadata(const ProcessKey& Key, ProcessMetadata& Out) const override {
+		Out.imagePath = "C:\\Synthetic\\process_" + std::to_string(Key.pid) + ".exe";
+		Out.bitness = (Key.pid % 5 == 0) ? 32 : 64;
+		Out.sessionId = (Key.pid % 7 == 0) ? 0 : 1;
+		Out.workingSetBytes = (static_cast<std::uint64_t>(Key.pid) % 997 + 1) * 64 * 1024;
+		return true;
+	}
+};
+
+std::unique_ptr<ProcessSource> CreateSyntheticProcessSource(size_t ProcessCount, unsigned Seed, double ChurnPerRefresh) {
+	return std::make_unique<SyntheticProcessSource>(ProcessCount, Seed, ChurnPerRefresh);
+}
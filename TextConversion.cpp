@@ -0,0 +1,91 @@
+#include "TextConversion.h"
+#include <cstdint>
+
+static constexpr char32_t ReplacementCharacter = 0xFFFD;
+
+static void AppendCodePointUtf8(char32_t CodePoint, std::string& Out) {
+	if (CodePoint < 0x80) {
+		Out += static_cast<char>(CodePoint);
+	} else if (CodePoint < 0x800) {
+		Out += static_cast<char>(0xC0 | (CodePoint >> 6));
+		Out += static_cast<char>(0x80 | (CodePoint & 0x3F));
+	} else if (CodePoint < 0x10000) {
+		Out += static_cast<char>(0xE0 | (CodePoint >> 12));
+		Out += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F));
+		Out += static_cast<char>(0x80 | (CodePoint & 0x3F));
+	} else {
+		Out += static_cast<char>(0xF0 | (CodePoint >> 18));
+		Out += static_cast<char>(0x80 | ((CodePoint >> 12) & 0x3F));
+		Out += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F));
+		Out += static_cast<char>(0x80 | (CodePoint & 0x3F));
+	}
+}
+
+static void AppendCodePointWide(char32_t CodePoint, std::wstring& Out) {
+	if constexpr (sizeof(wchar_t) == 2) {
+		if (CodePoint >= 0x10000) {
+			CodePoint -= 0x10000;
+			Out += static_cast<wchar_t>(0xD800 + (CodePoint >> 10));
+			Out += static_cast<wchar_t>(0xDC00 + (CodePoint & 0x3FF));
+			return;
+		}
+	}
+	Out += static_cast<wchar_t>(CodePoint);
+}
+
+void AppendUtf8FromWide(std::wstring_view Text, std::string& Out) {
+	Out.reserve(Out.size() + Text.size());
+	for (size_t Index = 0; Index < Text.size(); ++Index) {
+		char32_t CodePoint = static_cast<char32_t>(Text[Index]);
+		if constexpr (sizeof(wchar_t) == 2) {
+			if (CodePoint >= 0xD800 && CodePoint <= 0xDBFF && Index + 1 < Text.size()) {
+				const char32_t Low = static_cast<char32_t>(Text[Index + 1]);
+				if (Low >= 0xDC00 && Low <= 0xDFFF) {
+					CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (Low - 0xDC00);
+					++Index;
+				}
+			}
+		}
+		if ((CodePoint >= 0xD800 && CodePoint <= 0xDFFF) || CodePoint > 0x10FFFF) {
+			CodePoint = ReplacementCharacter; // Unpaired surrogate or out of range
+		}
+		AppendCodePointUtf8(CodePoint, Out);
+	}
+}
+
+void AppendWideFromUtf8(std::string_view Text, std::wstring& Out) {
+	Out.reserve(Out.size() + Text.size());
+	size_t Index = 0;
+	while (Index < Text.size()) {
+		const std::uint8_t Lead = static_cast<std::uint8_t>(Text[Index]);
+		size_t Length = 1;
+		char32_t CodePoint = ReplacementCharacter;
+		if (Lead < 0x80) {
+			CodePoint = Lead;
+		} else if (Lead >= 0xC2 && Lead <= 0xF4) {
+			Length = Lead < 0xE0 ? 2 : (Lead < 0xF0 ? 3 : 4);
+			if (Index + Length <= Text.size()) {
+				CodePoint = Lead & (0x7F >> Length);
+				for (size_t Continuation = 1; Continuation < Length; ++Continuation) {
+					const std::uint8_t Byte = static_cast<std::uint8_t>(Text[Index + Continuation]);
+					if ((Byte & 0xC0) != 0x80) {
+						CodePoint = ReplacementCharacter;
+						Length = Continuation;
+						break;
+					}
+					CodePoint = (CodePoint << 6) | (Byte & 0x3F);
+				}
+				// Reject overlong forms, surrogates and values past U+10FFFF
+				static constexpr char32_t Minimum[] = { 0, 0, 0x80, 0x800, 0x10000 };
+				if (CodePoint != ReplacementCharacter &&
+					(CodePoint < Minimum[Length] || (CodePoint >= 0xD800 && CodePoint <= 0xDFFF) || CodePoint > 0x10FFFF)) {
+					CodePoint = ReplacementCharacter;
+				}
+			} else {
+				Length = Text.size() - Index; // Truncated sequence at the end
+			}
+		}
+		AppendCodePointWide(CodePoint, Out);
+		Index += Length;
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+// Portable UTF-8 <-> wchar_t conversion. wchar_t is UTF-16 on Windows and UTF-32 elsewhere.
+// Invalid sequences become U+FFFD instead of failing.
+void AppendUtf8FromWide(std::wstring_view Text, std::string& Out);
+void AppendWideFromUtf8(std::string_view Text, std::wstring& Out);
+
+inline std::string Utf8FromWide(std::wstring_view Text) {
+	std::string Out;
+	AppendUtf8FromWide(Text, Out);
+	return Out;
+}
+
+inline std::wstring WideFromUtf8(std::string_view Text) {
+	std::wstring Out;
+	AppendWideFromUtf8(Text, Out);
+	return Out;
+}
@@ -1,8 +1,7 @@
 #include "TitleBarUI.h"
 #include <imgui.h>
-#include <tchar.h> // For _T macro if you use it, though not strictly needed for ImGui text
 
-TitleBarUI::TitleBarUI(HWND OwnerHWND) : OwnerHWND(OwnerHWND) {}
+TitleBarUI::TitleBarUI(UIHost& Host) : Host(Host) {}
 
 TitleBarUI::~TitleBarUI() = default;
 
@@ -35,12 +34,13 @@ void TitleBarUI::Render() {
     ImVec2 titleBarWindowPos = ImGui::GetWindowPos(); // Screen coordinates
     ImVec2 titleBarWindowSize = ImGui::GetWindowSize();
 
-    // Convert screen coordinates of the title bar to client coordinates of the main HWND
-    POINT titleBarTopLeftScreen = { (LONG)titleBarWindowPos.x, (LONG)titleBarWindowPos.y };
-    ScreenToClient(OwnerHWND, &titleBarTopLeftScreen);
+    // Convert screen coordinates of the title bar to client coordinates of the host window
+    float titleBarLeft = titleBarWindowPos.x;
+    float titleBarTop = titleBarWindowPos.y;
+    Host.ScreenToClientPoint(titleBarLeft, titleBarTop);
 
-    TitleBarMinX = (float)titleBarTopLeftScreen.x;
-    TitleBarMinY = (float)titleBarTopLeftScreen.y;
+    TitleBarMinX = titleBarLeft;
+    TitleBarMinY = titleBarTop;
     TitleBarMaxX = TitleBarMinX + titleBarWindowSize.x;
     TitleBarMaxY = TitleBarMinY + titleBarWindowSize.y; // The entire ImGui window is the draggable area
 
@@ -53,11 +53,11 @@ void TitleBarUI::Render() {
 
     ImGui::SameLine(ImGui::GetWindowWidth() - (buttonWidth * 2) - (spacing * 2) - 10.0f); // Position buttons from the right
     if (ImGui::Button("Minimize", ImVec2(buttonWidth, buttonHeight))) {
-        ShowWindow(OwnerHWND, SW_MINIMIZE);
+        Host.RequestMinimize();
     }
     ImGui::SameLine(ImGui::GetWindowWidth() - buttonWidth - spacing - 10.0f );
     if (ImGui::Button("Close", ImVec2(buttonWidth, buttonHeight))) {
-        PostMessage(OwnerHWND, WM_CLOSE, 0, 0);
+        Host.RequestClose();
     }
     ImGui::End();
 }
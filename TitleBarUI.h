@@ -1,9 +1,9 @@
 #pragma once
-#include <Windows.h>
+#include "UIHost.h"
 
 struct TitleBarUI {
 private:
-    HWND OwnerHWND;
+    UIHost& Host;
     // Store the client coordinates of the draggable title bar area
     float TitleBarMinX = 0.0f;
     float TitleBarMinY = 0.0f;
@@ -11,7 +11,7 @@ private:
     float TitleBarMaxY = 0.0f; // This will define the height of the draggable area
 
 public:
-    explicit TitleBarUI(HWND OwnerHWND);
+    explicit TitleBarUI(UIHost& Host);
     ~TitleBarUI();
 
     void Render();
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+// The window services InjectorUI and TitleBarUI call into. D3DApplication implements it for the
+// Win32 window; HeadlessImGui supplies a stub so the panels can render without Win32 or D3D11.
+struct UIHost {
+	virtual ~UIHost() = default;
+
+	// Thread-safe: wakes the render loop so a background result gets drawn
+	virtual void RequestRedraw() = 0;
+	virtual void RequestMinimize() = 0;
+	virtual void RequestClose() = 0;
+	// ImGui (screen) coordinates to the client area of the host window
+	virtual void ScreenToClientPoint(float& X, float& Y) const = 0;
+	// Opens the file picker without blocking the render loop. OnChosen gets the UTF-8 path, or an empty
+	// string when cancelled, on any thread, and never after the host has destroyed the panels.
+	// Returns false when a picker is already open.
+	virtual bool BrowseForDLL(std::function<void(std::string)> OnChosen) = 0;
+	// Where exported files such as InjectionHistory.jsonl are written
+	virtual std::filesystem::path DataDirectory() const = 0;
+};
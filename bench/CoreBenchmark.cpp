@@ -0,0 +1,346 @@
+// Benchmarks the non-UI core on real and synthetic data sets: process snapshot acquisition, table and
+// label construction, snapshot publishing, filtering, PID lookup and PE parsing.
+//
+//   CoreBenchmark [--sizes 100,1000,10000,100000] [--no-real] [--pe-corpus DIR]
+//                 [--json FILE] [--baseline FILE] [--tolerance 0.5] [--quick]
+//
+// --json writes one JSON object per measurement. A stored run passed as --baseline is compared
+// case by case. Exit codes: 2 when any median is slower than baseline * (1 + tolerance), 3 when the
+// baseline cannot be read, 1 for bad arguments or an unwritable --json file.
+// Baselines are machine-specific; regenerate them with --no-real --json on the machine that checks them.
+#include "PEImage.h"
+#include "ProcessSource.h"
+#include "ProcessTable.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <system_error>
+
+using Clock = std::chrono::steady_clock;
+
+struct Measurement {
+	std::string Case;
+	std::string Dataset;
+	size_t Rows = 0;
+	size_t Samples = 0;
+	double MedianNs = 0.0; // Per operation
+	double P95Ns = 0.0;
+	double MinNs = 0.0;
+};
+
+struct BenchmarkOptions {
+	DynamicArray<size_t> Sizes = { 100, 1000, 10000, 100000 };
+	bool Real = true;
+	bool Quick = false;
+	std::string PECorpus;
+	std::string JsonPath;
+	std::string BaselinePath;
+	double Tolerance = 0.5;
+};
+
+static BenchmarkOptions Options;
+static DynamicArray<Measurement> Results;
+
+// Runs Body (OpsPerSample operations per call) until enough samples and time have passed, then records
+// per-operation statistics. Samples rather than a single total, so one descheduled run does not skew the median.
+template <typename Body>
+static void Measure(const char* Case, const std::string& Dataset, size_t Rows, size_t OpsPerSample, Body&& Run) {
+	const size_t MinSamples = Options.Quick ? 3 : 7;
+	const size_t MaxSamples = 2000;
+	const auto MinDuration = std::chrono::milliseconds(Options.Quick ? 50 : 300);
+
+	DynamicArray<double> Samples;
+	const auto Start = Clock::now();
+	while (Samples.size() < MaxSamples && (Samples.size() < MinSamples || Clock::now() - Start < MinDuration)) {
+		const auto SampleStart = Clock::now();
+		Run();
+		Samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - SampleStart).count() / static_cast<double>(OpsPerSample));
+	}
+	std::sort(Samples.begin(), Samples.end());
+
+	Measurement Result;
+	Result.Case = Case;
+	Result.Dataset = Dataset;
+	Result.Rows = Rows;
+	Result.Samples = Samples.size();
+	Result.MedianNs = Samples[Samples.size() / 2];
+	Result.P95Ns = Samples[std::min(Samples.size() - 1, Samples.size() * 95 / 100)];
+	Result.MinNs = Samples.front();
+	std::printf("%-26s %-18s %8zu rows %14.1f ns %14.1f ns p95 %6zu samples\n", Case, Dataset.c_str(), Rows,
+		Result.MedianNs, Result.P95Ns, Result.Samples);
+	Results.push_back(std::move(Result));
+}
+
+// Keeps the optimizer from discarding a result
+static volatile size_t Sink;
+
+static void BenchmarkProcesses(const std::string& Dataset, const std::function<std::unique_ptr<ProcessSource>(double Churn)>& MakeSource) {
+	auto Source = MakeSource(0.0);
+	size_t Rows = 0;
+	Source->Enumerate([&](const ProcessSourceEntry&) { ++Rows; });
+
+	Measure("enumerate", Dataset, Rows, 1, [&] {
+		size_t Count = 0;
+		Source->Enumerate([&](const ProcessSourceEntry& Entry) { Count += Entry.pid != 0; });
+		Sink = Count;
+	});
+
+	// A fresh table converts every name and builds every label
+	Measure("table.build", Dataset, Rows, 1, [&] {
+		ProcessTable Table;
+		Table.RefreshProcessIDList(*Source);
+		Sink = Table.Processes().Size();
+	});
+
+	// Steady state: a warm table absorbing 1% churn per refresh (real data churns on its own)
+	auto ChurningSource = MakeSource(0.01);
+	ProcessTable Table;
+	Table.RefreshProcessIDList(*ChurningSource);
+	Measure("table.refresh", Dataset, Rows, 1, [&] { Sink = Table.RefreshProcessIDList(*ChurningSource); });
+
+	Measure("snapshot.make", Dataset, Rows, 1, [&] { Sink = Table.MakeSnapshot(1)->Processes.Size(); });
+
+	// Filtering and lookups run on the unchurned list: how many refreshes the loop above ran depends on
+	// machine speed and --quick, so its table is a different data set every run
+	ProcessTable StableTable;
+	StableTable.RefreshProcessIDList(*Source);
+	const auto Snapshot = StableTable.MakeSnapshot(1);
+	const char* const Queries[] = { "s", "svc", "host", "worker_12", "(4000)", "doesnotexist" };
+	for (const char* Query : Queries) {
+		const std::string Case = std::string("filter.query:") + Query;
+		Measure(Case.c_str(), Dataset, Rows, 1, [&] {
+			ProcessFilter Filter;
+			Filter.Update(Snapshot->SearchIndex, 1, Query);
+			Sink = Filter.MatchingRows().size();
+		});
+	}
+
+	// Typing "svchost" one character at a time: each keystroke narrows the previous result
+	const std::string_view Typed = "svchost";
+	Measure("filter.typing", Dataset, Rows, Typed.size(), [&] {
+		ProcessFilter Filter;
+		for (size_t Length = 1; Length <= Typed.size(); ++Length) {
+			Filter.Update(Snapshot->SearchIndex, 1, Typed.substr(0, Length));
+		}
+		Sink = Filter.MatchingRows().size();
+	});
+
+	// Half the probes hit, half miss, in random order so the branch predictor cannot learn them
+	constexpr size_t LookupCount = 4096;
+	DynamicArray<ProcessID> Probes(LookupCount);
+	std::mt19937 Random(7);
+	for (ProcessID& Probe : Probes) {
+		const size_t Row = Snapshot->Processes.Size() ? Random() % Snapshot->Processes.Size() : 0;
+		Probe = (Random() & 1) && Snapshot->Processes.Size() ? Snapshot->Processes.Pids[Row] : static_cast<ProcessID>(Random() | 1);
+	}
+	Measure("lookup.pid", Dataset, Rows, LookupCount, [&] {
+		size_t Found = 0;
+		for (ProcessID Probe : Probes) {
+			Found += Snapshot->FindRow(Probe) >= 0;
+		}
+		Sink = Found;
+	});
+}
+
+static void BenchmarkPEParsing() {
+	const std::filesystem::path Directory = std::filesystem::temp_directory_path();
+	for (std::uint32_t ExportCount : { 16u, 1024u, 16384u }) {
+		SyntheticPEOptions Shape;
+		Shape.exportCount = ExportCount;
+		Shape.importModules = 16;
+		const DynamicArray<std::uint8_t> Image = MakeSyntheticPEImage(Shape).bytes;
+		const PEImageInfo Check = ParsePEImage(Image.data(), Image.size());
+		if (!Check.IsValid() || Check.exportNames.size() != ExportCount || Check.imports.size() != 16) {
+			std::fprintf(stderr, "synthetic DLL with %u exports did not parse back: %s\n", ExportCount, Check.error.c_str());
+			std::exit(1);
+		}
+
+		const std::string Dataset = "pe-exports-" + std::to_string(ExportCount);
+		Measure("pe.parse", Dataset, ExportCount, 1, [&] { Sink = ParsePEImage(Image.data(), Image.size()).exportNames.size(); });
+
+		const std::filesystem::path Path = Directory / ("ShadowBindBenchmark_" + std::to_string(ExportCount) + ".dll");
+		std::ofstream(Path, std::ios::binary).write(reinterpret_cast<const char*>(Image.data()), static_cast<std::streamsize>(Image.size()));
+		Measure("pe.parse_file", Dataset, ExportCount, 1, [&] { Sink = ParsePEFile(Path).exportNames.size(); });
+		PEImageCache Cache;
+		const std::string Utf8Path = Path.string();
+		Cache.Get(Utf8Path);
+		Measure("pe.cache_hit", Dataset, ExportCount, 1, [&] { Sink = Cache.Get(Utf8Path) != nullptr; });
+		std::error_code Error;
+		std::filesystem::remove(Path, Error);
+	}
+
+	if (Options.PECorpus.empty()) {
+		return;
+	}
+	DynamicArray<std::filesystem::path> Corpus;
+	std::error_code Error;
+	for (const auto& Entry : std::filesystem::recursive_directory_iterator(Options.PECorpus, Error)) {
+		std::string Extension = Entry.path().extension().string();
+		std::transform(Extension.begin(), Extension.end(), Extension.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+		if (Entry.is_regular_file() && (Extension == ".dll" || Extension == ".exe")) {
+			Corpus.push_back(Entry.path());
+		}
+	}
+	if (Corpus.empty()) {
+		std::fprintf(stderr, "no .dll or .exe files under %s\n", Options.PECorpus.c_str());
+		return;
+	}
+	Measure("pe.parse_file", "pe-corpus", Corpus.size(), Corpus.size(), [&] {
+		size_t Valid = 0;
+		for (const std::filesystem::path& Path : Corpus) {
+			Valid += ParsePEFile(Path).IsValid();
+		}
+		Sink = Valid;
+	});
+}
+
+static std::string JsonEscape(const std::string& Text) {
+	std::string Out;
+	for (char c : Text) {
+		if (c == '"' || c == '\\') {
+			Out += '\\';
+		}
+		Out += c;
+	}
+	return Out;
+}
+
+static bool WriteJson(const std::string& Path) {
+	std::ofstream Out(Path, std::ios::binary | std::ios::trunc);
+	for (const Measurement& Result : Results) {
+		char Numbers[192];
+		std::snprintf(Numbers, sizeof(Numbers), "\"rows\":%zu,\"samples\":%zu,\"median_ns\":%.1f,\"p95_ns\":%.1f,\"min_ns\":%.1f",
+			Result.Rows, Result.Samples, Result.MedianNs, Result.P95Ns, Result.MinNs);
+		Out << "{\"case\":\"" << JsonEscape(Result.Case) << "\",\"dataset\":\"" << JsonEscape(Result.Dataset) << "\"," << Numbers << "}\n";
+	}
+	return static_cast<bool>(Out);
+}
+
+// Reads "Name":"text" or "Name":number from one line written by WriteJson
+static std::string JsonField(const std::string& Line, const char* Name) {
+	const std::string Key = std::string("\"") + Name + "\":";
+	size_t Start = Line.find(Key);
+	if (Start == std::string::npos) {
+		return {};
+	}
+	Start += Key.size();
+	if (Line[Start] == '"') {
+		std::string Value;
+		for (size_t Index = Start + 1; Index < Line.size() && Line[Index] != '"'; ++Index) {
+			if (Line[Index] == '\\' && Index + 1 < Line.size()) {
+				++Index;
+			}
+			Value += Line[Index];
+		}
+		return Value;
+	}
+	return Line.substr(Start, Line.find_first_of(",}", Start) - Start);
+}
+
+// Returns the number of regressions, or -1 when the baseline cannot be read
+static int CompareWithBaseline(const std::string& Path) {
+	std::ifstream Baseline(Path);
+	if (!Baseline) {
+		std::fprintf(stderr, "cannot read baseline %s\n", Path.c_str());
+		return -1;
+	}
+	int Regressions = 0, Compared = 0;
+	std::printf("\nAgainst %s (tolerance %.0f%%):\n", Path.c_str(), Options.Tolerance * 100.0);
+	std::string Line;
+	while (std::getline(Baseline, Line)) {
+		const std::string Case = JsonField(Line, "case"), Dataset = JsonField(Line, "dataset");
+		const double BaselineNs = std::atof(JsonField(Line, "median_ns").c_str());
+		const auto Current = std::find_if(Results.begin(), Results.end(), [&](const Measurement& Result) {
+			return Result.Case == Case && Result.Dataset == Dataset;
+		});
+		if (Current == Results.end() || BaselineNs <= 0.0) {
+			continue; // Not run this time, e.g. a size left out with --sizes
+		}
+		++Compared;
+		// Sub-microsecond cases jitter by more than any tolerance, so a change must also exceed an absolute slack
+		const double Ratio = Current->MedianNs / BaselineNs;
+		const bool Significant = std::abs(Current->MedianNs - BaselineNs) > 250.0;
+		const bool Regressed = Significant && Ratio > 1.0 + Options.Tolerance;
+		Regressions += Regressed;
+		if (Regressed || (Significant && Ratio < 1.0 / (1.0 + Options.Tolerance))) {
+			std::printf("  %-10s %-26s %-18s %12.1f ns -> %12.1f ns (x%.2f)\n", Regressed ? "REGRESSED" : "improved",
+				Case.c_str(), Dataset.c_str(), BaselineNs, Current->MedianNs, Ratio);
+		}
+	}
+	std::printf("  %d cases compared, %d regressed\n", Compared, Regressions);
+	return Regressions;
+}
+
+static bool ParseArguments(int ArgumentCount, char** Arguments) {
+	for (int Index = 1; Index < ArgumentCount; ++Index) {
+		const std::string Argument = Arguments[Index];
+		const char* Value = Index + 1 < ArgumentCount ? Arguments[Index + 1] : nullptr;
+		if (Argument == "--no-real") {
+			Options.Real = false;
+		} else if (Argument == "--quick") {
+			Options.Quick = true;
+		} else if (Argument == "--sizes" && Value) {
+			Options.Sizes.clear();
+			for (const char* Cursor = Value; *Cursor;) {
+				char* End = nullptr;
+				Options.Sizes.push_back(std::strtoull(Cursor, &End, 10));
+				Cursor = *End == ',' ? End + 1 : End;
+				if (End == Cursor && *End) {
+					return false;
+				}
+			}
+			++Index;
+		} else if (Argument == "--pe-corpus" && Value) {
+			Options.PECorpus = Value;
+			++Index;
+		} else if (Argument == "--json" && Value) {
+			Options.JsonPath = Value;
+			++Index;
+		} else if (Argument == "--baseline" && Value) {
+			Options.BaselinePath = Value;
+			++Index;
+		} else if (Argument == "--tolerance" && Value) {
+			Options.Tolerance = std::atof(Value);
+			++Index;
+		} else {
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int ArgumentCount, char** Arguments) {
+	if (!ParseArguments(ArgumentCount, Arguments)) {
+		std::fprintf(stderr, "usage: %s [--sizes 100,1000,10000,100000] [--no-real] [--pe-corpus DIR] [--json FILE] "
+			"[--baseline FILE] [--tolerance 0.5] [--quick]\n", Arguments[0]);
+		return 1;
+	}
+
+	std::printf("%-26s %-18s %13s %17s\n", "case", "dataset", "", "median per op");
+	for (size_t Size : Options.Sizes) {
+		BenchmarkProcesses("synthetic-" + std::to_string(Size), [Size](double Churn) { return CreateSyntheticProcessSource(Size, 1, Churn); });
+	}
+	if (Options.Real) {
+		BenchmarkProcesses("real", [](double) { return CreatePlatformProcessSource(); });
+	}
+	BenchmarkPEParsing();
+
+	if (!Options.JsonPath.empty() && !WriteJson(Options.JsonPath)) {
+		std::fprintf(stderr, "cannot write %s\n", Options.JsonPath.c_str());
+		return 1;
+	}
+	const int Regressions = Options.BaselinePath.empty() ? 0 : CompareWithBaseline(Options.BaselinePath);
+	if (Regressions < 0) {
+		return 3;
+	}
+	return Regressions > 0 ? 2 : 0;
+}
@@ -0,0 +1,338 @@
+// Replays input scripts against InjectorUI and TitleBarUI on the headless ImGui backend and reports
+// per-frame CPU cost and allocation counts, over synthetic process lists of several sizes.
+//
+// Usage: UIReplayHarness [--processes N]... [--script FILE]... [--frames-csv FILE]
+// Without --script the built-in scripts run. Script commands, one per line ('#' starts a comment):
+//   section NAME   start a new reporting section     frames N     render N idle frames
+//   display W H    resize the display                move X Y     move the mouse, 1 frame
+//   click          press and release the left button (2 frames)
+//   wheel D        scroll by D notches, 1 frame       type TEXT    one character per frame
+//   key NAME       press and release a key (Escape, Enter, Backspace, Tab, UpArrow, DownArrow, PageUp, PageDown)
+//   wait_redraw    block until a worker requests a redraw (snapshot or metadata published), then 1 frame.
+//                  Background work starts after the first frame, so one is rendered first if there was none yet.
+#include "HeadlessImGui.h"
+#include "InjectorUI.h"
+#include "TitleBarUI.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Allocations are counted per thread, so the enumeration and metadata workers don't show up in frame numbers
+static thread_local unsigned long long HeapAllocations = 0;  // operator new
+static thread_local unsigned long long ImGuiAllocations = 0; // ImGui::MemAlloc
+
+void* operator new(std::size_t Size) {
+	++HeapAllocations;
+	if (void* Memory = std::malloc(Size ? Size : 1)) {
+		return Memory;
+	}
+	throw std::bad_alloc();
+}
+void* operator new[](std::size_t Size) { return operator new(Size); }
+void operator delete(void* Memory) noexcept { std::free(Memory); }
+void operator delete[](void* Memory) noexcept { std::free(Memory); }
+void operator delete(void* Memory, std::size_t) noexcept { std::free(Memory); }
+void operator delete[](void* Memory, std::size_t) noexcept { std::free(Memory); }
+
+static void* CountingImGuiAlloc(size_t Size, void*) {
+	++ImGuiAllocations;
+	return std::malloc(Size);
+}
+static void CountingImGuiFree(void* Memory, void*) {
+	std::free(Memory);
+}
+
+using Clock = std::chrono::steady_clock;
+
+static const char* const BuiltInScripts[][2] = {
+	{ "open-combo",
+		"section load\nwait_redraw\nframes 2\n"
+		"section idle\nframes 30\n"
+		"section open\nmove 150 116\nclick\nframes 5\n"
+		"section close\nkey Escape\nframes 2\n" },
+	{ "scroll",
+		"wait_redraw\nframes 2\nmove 150 116\nclick\nframes 2\n"
+		"section scroll\nmove 150 300\nwheel -3\nwheel -3\nwheel -3\nwheel -3\nwheel -3\nwheel 3\nwheel 3\nkey PageDown\nkey PageDown\nkey PageUp\n"
+		"section close\nkey Escape\nframes 2\n" },
+	{ "type-filter",
+		"wait_redraw\nframes 2\nmove 150 116\nclick\nframes 2\n"
+		"section type\ntype svchost\n"
+		"section erase\nkey Backspace\nkey Backspace\nkey Backspace\nkey Backspace\nkey Backspace\nkey Backspace\nkey Backspace\n"
+		"section type-unique\ntype worker_12\n"
+		"section close\nkey Escape\nframes 2\n" },
+};
+
+struct FrameRecord {
+	std::string Script;
+	std::string Section;
+	size_t ProcessCount = 0;
+	double Microseconds = 0.0;
+	unsigned long long HeapAllocations = 0;
+	unsigned long long ImGuiAllocations = 0;
+	int Vertices = 0;
+};
+
+struct ReplaySession {
+	HeadlessUIHost Host;
+	HeadlessImGui Backend;
+	TitleBarUI TitleBar;
+	InjectorUI Injector;
+	unsigned long long SeenRedraws = 0;
+	bool BackgroundStarted = false;
+
+	explicit ReplaySession(size_t ProcessCount)
+		: TitleBar(Host),
+		Injector(Host, CreateSyntheticProcessSource(ProcessCount), CreateSyntheticProcessSource(ProcessCount),
+			CreateSyntheticProcessSource(ProcessCount), CreatePlatformInjectionBackend()) {}
+
+	FrameRecord Frame() {
+		FrameRecord Record;
+		const unsigned long long HeapBefore = HeapAllocations;
+		const unsigned long long ImGuiBefore = ImGuiAllocations;
+		const auto Start = Clock::now();
+		Backend.NewFrame();
+		TitleBar.Render();
+		Injector.Render();
+		const ImDrawData* DrawData = Backend.Render();
+		Record.Microseconds = std::chrono::duration<double, std::micro>(Clock::now() - Start).count();
+		Record.HeapAllocations = HeapAllocations - HeapBefore;
+		Record.ImGuiAllocations = ImGuiAllocations - ImGuiBefore;
+		Record.Vertices = DrawData ? DrawData->TotalVtxCount : 0;
+		if (!BackgroundStarted) {
+			Injector.StartBackgroundWork(); // Like D3DApplication, after the first frame
+			BackgroundStarted = true;
+		}
+		return Record;
+	}
+
+	bool WaitForRedraw(std::chrono::milliseconds Timeout) {
+		const auto Deadline = Clock::now() + Timeout;
+		while (Host.RedrawRequests.load(std::memory_order_acquire) == SeenRedraws) {
+			if (Clock::now() >= Deadline) {
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		SeenRedraws = Host.RedrawRequests.load(std::memory_order_acquire);
+		return true;
+	}
+};
+
+static bool ParseKey(const std::string& Name, ImGuiKey& Key) {
+	static const struct { const char* Name; ImGuiKey Key; } Keys[] = {
+		{ "Escape", ImGuiKey_Escape }, { "Enter", ImGuiKey_Enter }, { "Backspace", ImGuiKey_Backspace },
+		{ "Tab", ImGuiKey_Tab }, { "UpArrow", ImGuiKey_UpArrow }, { "DownArrow", ImGuiKey_DownArrow },
+		{ "PageUp", ImGuiKey_PageUp }, { "PageDown", ImGuiKey_PageDown },
+	};
+	for (const auto& Entry : Keys) {
+		if (Name == Entry.Name) {
+			Key = Entry.Key;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Returns false on a malformed line; frames rendered so far are kept
+static bool RunScript(const char* ScriptName, const std::string& Script, size_t ProcessCount, std::vector<FrameRecord>& Records) {
+	ReplaySession Session(ProcessCount);
+	ImGuiIO& IO = ImGui::GetIO();
+	std::string Section = "main";
+	auto Frame = [&] {
+		FrameRecord Record = Session.Frame();
+		Record.Script = ScriptName;
+		Record.Section = Section;
+		Record.ProcessCount = ProcessCount;
+		Records.push_back(std::move(Record));
+	};
+
+	std::istringstream Lines(Script);
+	std::string Line;
+	int LineNumber = 0;
+	while (std::getline(Lines, Line)) {
+		++LineNumber;
+		std::istringstream Words(Line.substr(0, Line.find('#')));
+		std::string Command;
+		if (!(Words >> Command)) {
+			continue;
+		}
+		bool Valid = true;
+		if (Command == "section") {
+			Valid = static_cast<bool>(Words >> Section);
+		} else if (Command == "frames") {
+			int Count = 0;
+			Valid = static_cast<bool>(Words >> Count);
+			for (int Index = 0; Valid && Index < Count; ++Index) {
+				Frame();
+			}
+		} else if (Command == "display") {
+			float Width = 0.0f, Height = 0.0f;
+			Valid = static_cast<bool>(Words >> Width >> Height);
+			if (Valid) {
+				Session.Backend.SetDisplaySize(Width, Height);
+			}
+		} else if (Command == "move") {
+			float X = 0.0f, Y = 0.0f;
+			Valid = static_cast<bool>(Words >> X >> Y);
+			if (Valid) {
+				IO.AddMousePosEvent(X, Y);
+				Frame();
+			}
+		} else if (Command == "click") {
+			IO.AddMouseButtonEvent(ImGuiMouseButton_Left, true);
+			Frame();
+			IO.AddMouseButtonEvent(ImGuiMouseButton_Left, false);
+			Frame();
+		} else if (Command == "wheel") {
+			float Notches = 0.0f;
+			Valid = static_cast<bool>(Words >> Notches);
+			if (Valid) {
+				IO.AddMouseWheelEvent(0.0f, Notches);
+				Frame();
+			}
+		} else if (Command == "type") {
+			std::string Text;
+			Valid = static_cast<bool>(Words >> Text);
+			for (char Character : Text) {
+				IO.AddInputCharacter(static_cast<unsigned char>(Character));
+				Frame();
+			}
+		} else if (Command == "key") {
+			std::string Name;
+			ImGuiKey Key = ImGuiKey_None;
+			Valid = (Words >> Name) && ParseKey(Name, Key);
+			if (Valid) {
+				IO.AddKeyEvent(Key, true);
+				Frame();
+				IO.AddKeyEvent(Key, false);
+				Frame();
+			}
+		} else if (Command == "wait_redraw") {
+			if (!Session.BackgroundStarted) {
+				Frame(); // Nothing can request a redraw before the workers start
+			}
+			if (!Session.WaitForRedraw(std::chrono::seconds(5))) {
+				std::fprintf(stderr, "%s:%d: no redraw request within 5 s\n", ScriptName, LineNumber);
+			}
+			Frame();
+		} else {
+			Valid = false;
+		}
+		if (!Valid) {
+			std::fprintf(stderr, "%s:%d: cannot parse '%s'\n", ScriptName, LineNumber, Line.c_str());
+			return false;
+		}
+	}
+	return true;
+}
+
+static double Percentile(std::vector<double>& Values, double Fraction) {
+	if (Values.empty()) {
+		return 0.0;
+	}
+	const size_t Rank = std::min(Values.size() - 1, static_cast<size_t>(Fraction * Values.size()));
+	std::nth_element(Values.begin(), Values.begin() + Rank, Values.end());
+	return Values[Rank];
+}
+
+// One line per script, process count and section, in the order they first appear
+static void PrintSummary(const std::vector<FrameRecord>& Records) {
+	std::printf("%-12s %-12s %7s %6s %9s %9s %9s %10s %10s %9s\n", "script", "section", "procs", "frames",
+		"p50 us", "p95 us", "max us", "new/frame", "imgui/frm", "vertices");
+	size_t Begin = 0;
+	while (Begin < Records.size()) {
+		size_t End = Begin;
+		std::vector<double> Times;
+		unsigned long long Heap = 0, ImGuiCount = 0;
+		int Vertices = 0;
+		while (End < Records.size() && Records[End].Script == Records[Begin].Script &&
+			Records[End].Section == Records[Begin].Section && Records[End].ProcessCount == Records[Begin].ProcessCount) {
+			Times.push_back(Records[End].Microseconds);
+			Heap += Records[End].HeapAllocations;
+			ImGuiCount += Records[End].ImGuiAllocations;
+			Vertices = std::max(Vertices, Records[End].Vertices);
+			++End;
+		}
+		const double Frames = static_cast<double>(Times.size());
+		const double Maximum = *std::max_element(Times.begin(), Times.end());
+		const double Median = Percentile(Times, 0.50);
+		const double Tail = Percentile(Times, 0.95);
+		std::printf("%-12s %-12s %7zu %6zu %9.1f %9.1f %9.1f %10.1f %10.1f %9d\n", Records[Begin].Script.c_str(),
+			Records[Begin].Section.c_str(), Records[Begin].ProcessCount, Times.size(), Median, Tail, Maximum,
+			Heap / Frames, ImGuiCount / Frames, Vertices);
+		Begin = End;
+	}
+}
+
+static bool WriteFramesCsv(const char* Path, const std::vector<FrameRecord>& Records) {
+	std::ofstream File(Path, std::ios::binary);
+	if (!File) {
+		return false;
+	}
+	File << "script,section,processes,frame,us,new_allocs,imgui_allocs,vertices\n";
+	for (size_t Index = 0; Index < Records.size(); ++Index) {
+		const FrameRecord& Record = Records[Index];
+		File << Record.Script << ',' << Record.Section << ',' << Record.ProcessCount << ',' << Index << ','
+			<< Record.Microseconds << ',' << Record.HeapAllocations << ',' << Record.ImGuiAllocations << ',' << Record.Vertices << '\n';
+	}
+	return static_cast<bool>(File);
+}
+
+int main(int ArgumentCount, char** Arguments) {
+	std::vector<size_t> ProcessCounts;
+	std::vector<std::pair<std::string, std::string>> Scripts;
+	const char* FramesCsvPath = nullptr;
+	for (int Index = 1; Index < ArgumentCount; ++Index) {
+		const std::string Argument = Arguments[Index];
+		const bool HasValue = Index + 1 < ArgumentCount;
+		if (Argument == "--processes" && HasValue) {
+			ProcessCounts.push_back(std::strtoull(Arguments[++Index], nullptr, 10));
+		} else if (Argument == "--script" && HasValue) {
+			std::ifstream File(Arguments[++Index], std::ios::binary);
+			if (!File) {
+				std::fprintf(stderr, "cannot open script %s\n", Arguments[Index]);
+				return 1;
+			}
+			std::ostringstream Contents;
+			Contents << File.rdbuf();
+			Scripts.emplace_back(Arguments[Index], Contents.str());
+		} else if (Argument == "--frames-csv" && HasValue) {
+			FramesCsvPath = Arguments[++Index];
+		} else {
+			std::fprintf(stderr, "usage: %s [--processes N]... [--script FILE]... [--frames-csv FILE]\n", Arguments[0]);
+			return 1;
+		}
+	}
+	if (ProcessCounts.empty()) {
+		ProcessCounts = { 100, 1000, 10000 };
+	}
+	if (Scripts.empty()) {
+		for (const auto& Script : BuiltInScripts) {
+			Scripts.emplace_back(Script[0], Script[1]);
+		}
+	}
+
+	ImGui::SetAllocatorFunctions(&CountingImGuiAlloc, &CountingImGuiFree);
+	std::vector<FrameRecord> Records;
+	bool AllParsed = true;
+	for (size_t ProcessCount : ProcessCounts) {
+		for (const auto& [Name, Script] : Scripts) {
+			AllParsed = RunScript(Name.c_str(), Script, ProcessCount, Records) && AllParsed;
+		}
+	}
+
+	PrintSummary(Records);
+	if (FramesCsvPath && !WriteFramesCsv(FramesCsvPath, Records)) {
+		std::fprintf(stderr, "cannot write %s\n", FramesCsvPath);
+		return 1;
+	}
+	return AllParsed ? 0 : 1;
+}
@@ -1,7 +1,13 @@
 #include "D3DApplication.h"
+#include "StartupTrace.h"
 
-int WINAPI WinMain(HINSTANCE ApplicationInstance, HINSTANCE, LPSTR, int) {
+#include <cstring>
+
+int WINAPI WinMain(HINSTANCE ApplicationInstance, HINSTANCE, LPSTR CommandLine, int) {
+	StartupTrace::Global().Mark("WinMain");
 	D3DApplication Application(ApplicationInstance);
+	// Opt in to the flip-model, waitable swap chain for lower latency
+	Application.SetFlipModelSwapChain(CommandLine && std::strstr(CommandLine, "--flip-model") != nullptr);
 	if (!Application.Initialize(200, 200, 500, 500)) {
 		return -1;
 	}
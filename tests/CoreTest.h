@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdio>
+#include <vector>
+
+// A minimal self-registering test runner for the core. TEST_CASE defines a case, CHECK records a failure
+// and carries on, REQUIRE returns from the case when it fails.
+struct TestCase {
+	const char* Name;
+	void (*Run)();
+};
+
+std::vector<TestCase>& TestRegistry();
+void ReportFailure(const char* File, int Line, const char* Expression);
+
+struct TestRegistration {
+	TestRegistration(const char* Name, void (*Run)()) { TestRegistry().push_back({ Name, Run }); }
+};
+
+#define TEST_CASE(Name) \
+	static void Name(); \
+	static const TestRegistration Name##Registration(#Name, Name); \
+	static void Name()
+
+#define CHECK(Expression) ((Expression) ? (void)0 : ReportFailure(__FILE__, __LINE__, #Expression))
+
+#define REQUIRE(Expression) \
+	if (!(Expression)) { \
+		ReportFailure(__FILE__, __LINE__, #Expression); \
+		return; \
+	}
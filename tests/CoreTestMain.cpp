@@ -0,0 +1,34 @@
+// Runs every registered case, or those whose name contains the first argument
+#include "CoreTest.h"
+#include <cstring>
+
+static int Failures = 0;
+
+std::vector<TestCase>& TestRegistry() {
+	static std::vector<TestCase> Registry;
+	return Registry;
+}
+
+void ReportFailure(const char* File, int Line, const char* Expression) {
+	std::printf("  %s:%d: CHECK(%s) failed\n", File, Line, Expression);
+	++Failures;
+}
+
+int main(int ArgumentCount, char** Arguments) {
+	const char* Filter = ArgumentCount > 1 ? Arguments[1] : "";
+	int Run = 0, Failed = 0;
+	for (const TestCase& Case : TestRegistry()) {
+		if (!std::strstr(Case.Name, Filter)) {
+			continue;
+		}
+		const int FailuresBefore = Failures;
+		Case.Run();
+		++Run;
+		if (Failures != FailuresBefore) {
+			std::printf("FAILED %s\n", Case.Name);
+			++Failed;
+		}
+	}
+	std::printf("%d of %d test cases passed\n", Run - Failed, Run);
+	return Failed == 0 && Run > 0 ? 0 : 1;
+}
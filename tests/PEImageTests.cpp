@@ -0,0 +1,164 @@
+#include "CoreTest.h"
+#include "PEImage.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+static PEImageInfo Parse(const DynamicArray<std::uint8_t>& Bytes) {
+	return ParsePEImage(Bytes.data(), Bytes.size());
+}
+
+static void PutU32(DynamicArray<std::uint8_t>& Bytes, size_t Offset, std::uint32_t Value) {
+	for (size_t Index = 0; Index < 4; ++Index) {
+		Bytes[Offset + Index] = static_cast<std::uint8_t>(Value >> (8 * Index));
+	}
+}
+
+// Checks everything MakeSyntheticPEImage put into the image
+static void CheckParsesBack(const SyntheticPEOptions& Options) {
+	const PEImageInfo Info = Parse(MakeSyntheticPEImage(Options).bytes);
+	REQUIRE(Info.IsValid());
+	CHECK(Info.machine == (Options.is64Bit ? 0x8664 : 0x014C));
+	CHECK(Info.bitness == (Options.is64Bit ? 64 : 32));
+	CHECK(Info.subsystem == 2);
+	CHECK(Info.isDll);
+	CHECK(!Info.isManaged);
+	CHECK(Info.exportedFunctionCount == Options.exportCount);
+	REQUIRE(Info.exportNames.size() == Options.exportCount);
+	for (std::uint32_t Index = 0; Index < Options.exportCount; ++Index) {
+		CHECK(Info.exportNames[Index] == "Export_" + std::to_string(Index));
+	}
+	REQUIRE(Info.imports.size() == Options.importModules + Options.delayImportModules);
+	for (std::uint32_t Module = 0; Module < Info.imports.size(); ++Module) {
+		const PEImport& Import = Info.imports[Module];
+		const bool Delayed = Module >= Options.importModules;
+		const std::uint32_t Number = Delayed ? Module - Options.importModules : Module;
+		CHECK(Import.moduleName == (Delayed ? "delayed_" : "module_") + std::to_string(Number) + ".dll");
+		CHECK(Import.delayLoaded == Delayed);
+		CHECK(Import.functionCount == Options.functionsPerModule);
+	}
+}
+
+TEST_CASE(PEImageParsesPE32PlusDLL) {
+	SyntheticPEOptions Options;
+	Options.exportCount = 100;
+	Options.importModules = 3;
+	Options.delayImportModules = 2;
+	CheckParsesBack(Options);
+}
+
+TEST_CASE(PEImageParsesPE32DLL) {
+	SyntheticPEOptions Options;
+	Options.is64Bit = false;
+	Options.exportCount = 7;
+	Options.importModules = 5;
+	Options.delayImportModules = 1;
+	Options.functionsPerModule = 3;
+	CheckParsesBack(Options);
+}
+
+TEST_CASE(PEImageParsesDLLWithoutImports) {
+	SyntheticPEOptions Options;
+	Options.exportCount = 0;
+	Options.importModules = 0;
+	CheckParsesBack(Options);
+}
+
+TEST_CASE(PEImageRejectsTruncatedHeaders) {
+	const SyntheticPEImage Image = MakeSyntheticPEImage({});
+	for (size_t Length = 0; Length < Image.sectionTableEnd; ++Length) {
+		const PEImageInfo Info = ParsePEImage(Image.bytes.data(), Length);
+		CHECK(!Info.IsValid());
+	}
+	// Cut anywhere in the tables: the headers still parse and nothing is read past the end
+	for (size_t Length = Image.sectionTableEnd; Length < Image.bytes.size(); Length += 7) {
+		const DynamicArray<std::uint8_t> Truncated(Image.bytes.begin(), Image.bytes.begin() + static_cast<std::ptrdiff_t>(Length));
+		const PEImageInfo Info = Parse(Truncated);
+		CHECK(Info.IsValid());
+		CHECK(Info.exportNames.size() <= 16);
+	}
+}
+
+TEST_CASE(PEImageRejectsNtHeadersPastTheEnd) {
+	SyntheticPEImage Image = MakeSyntheticPEImage({});
+	for (std::uint32_t Offset : { static_cast<std::uint32_t>(Image.bytes.size()), static_cast<std::uint32_t>(Image.bytes.size() - 2), 0xFFFFFFFFu, 0xFFFFFFFEu }) {
+		PutU32(Image.bytes, 0x3C, Offset);
+		const PEImageInfo Info = Parse(Image.bytes);
+		CHECK(Info.error == "Not a PE image (no PE signature)");
+	}
+}
+
+TEST_CASE(PEImageRejectsMachineOptionalHeaderMismatch) {
+	SyntheticPEImage Image = MakeSyntheticPEImage({});
+	Image.bytes[Image.machineOffset] = 0x4C; // x86 machine over a PE32+ optional header
+	Image.bytes[Image.machineOffset + 1] = 0x01;
+	CHECK(Parse(Image.bytes).error == "Machine type does not match the optional header");
+
+	SyntheticPEOptions Options;
+	Options.is64Bit = false;
+	Image = MakeSyntheticPEImage(Options);
+	Image.bytes[Image.machineOffset] = 0x64; // x64 machine over a PE32 optional header
+	Image.bytes[Image.machineOffset + 1] = 0x86;
+	CHECK(Parse(Image.bytes).error == "Machine type does not match the optional header");
+}
+
+TEST_CASE(PEImageCapsOversizedNameCount) {
+	SyntheticPEImage Image = MakeSyntheticPEImage({});
+	PutU32(Image.bytes, Image.exportDirectoryOffset + 24, 0xFFFFFFFFu); // NumberOfNames
+	const PEImageInfo Info = Parse(Image.bytes);
+	REQUIRE(Info.IsValid());
+	REQUIRE(Info.exportNames.size() >= 16);
+	CHECK(Info.exportNames.size() <= (1u << 16));
+	CHECK(Info.exportNames[15] == "Export_15");
+}
+
+TEST_CASE(PEImageStopsAtUnterminatedNames) {
+	SyntheticPEOptions Options;
+	Options.importModules = 0;
+	SyntheticPEImage Image = MakeSyntheticPEImage(Options);
+	// Every byte from the first export name to the end of the file is non-zero, so no name ends
+	for (size_t Offset = Image.firstExportNameOffset; Offset < Image.bytes.size(); ++Offset) {
+		Image.bytes[Offset] = 'A';
+	}
+	const PEImageInfo Info = Parse(Image.bytes);
+	CHECK(Info.IsValid());
+	CHECK(Info.exportedFunctionCount == 16);
+	CHECK(Info.exportNames.empty());
+
+	// Only the last name runs into the end of the file
+	Image = MakeSyntheticPEImage(Options);
+	Image.bytes.pop_back();
+	const PEImageInfo LastCut = Parse(Image.bytes);
+	CHECK(LastCut.exportNames.size() == 15);
+}
+
+TEST_CASE(PEImageCacheRevalidatesFiles) {
+	const std::filesystem::path Directory = std::filesystem::temp_directory_path() / "ShadowBindCoreTests";
+	std::filesystem::create_directories(Directory);
+	const std::filesystem::path Path = Directory / "cached.dll";
+	const auto Write = [&](const SyntheticPEOptions& Options) {
+		const DynamicArray<std::uint8_t> Bytes = MakeSyntheticPEImage(Options).bytes;
+		std::ofstream(Path, std::ios::binary | std::ios::trunc).write(reinterpret_cast<const char*>(Bytes.data()), static_cast<std::streamsize>(Bytes.size()));
+	};
+
+	PEImageCache Cache;
+	Write({});
+	const auto First = Cache.Get(Path.string());
+	REQUIRE(First != nullptr);
+	CHECK(First->exportNames.size() == 16);
+	CHECK(Cache.Get(Path.string()) == First);
+
+	// A different size invalidates the entry even if the modification time did not tick
+	SyntheticPEOptions Larger;
+	Larger.exportCount = 40;
+	Write(Larger);
+	const auto Second = Cache.Get(Path.string());
+	REQUIRE(Second != nullptr);
+	CHECK(Second->exportNames.size() == 40);
+
+	CHECK(Cache.Get(Directory.string()) == nullptr);
+	CHECK(Cache.Get((Directory / "missing.dll").string()) == nullptr);
+	CHECK(Cache.Get("") == nullptr);
+	std::error_code Error;
+	std::filesystem::remove_all(Directory, Error);
+}
@@ -0,0 +1,43 @@
+#include "CoreTest.h"
+#include "ProcStat.h"
+#include <string>
+
+// A /proc/<pid>/stat line for Comm with the fields ParseStat reads set to recognizable values
+static std::string MakeStat(std::string_view Comm) {
+	std::string Stat = "4242 (";
+	Stat += Comm;
+	Stat += ") S 17 4242 33 0 -1 4194560 310 0 0 0 5 3 0 0 20 0 1 0 987654 12345678 321 18446744073709551615\n";
+	return Stat;
+}
+
+TEST_CASE(ProcStatParsesPlainName) {
+	const std::string Stat = MakeStat("bash");
+	ProcStat Parsed;
+	REQUIRE(ParseStat(Stat, Parsed));
+	CHECK(Parsed.name == "bash");
+	CHECK(Parsed.parentPid == 17);
+	CHECK(Parsed.sessionId == 33);
+	CHECK(Parsed.startTime == 987654);
+	CHECK(Parsed.residentPages == 321);
+}
+
+TEST_CASE(ProcStatParsesNamesWithSpacesAndParentheses) {
+	const char* const Names[] = { "Web Content", "a) b", "(sd-pam)", "x ) S 99 99 99", ")", "" };
+	for (const char* Name : Names) {
+		const std::string Stat = MakeStat(Name);
+		ProcStat Parsed;
+		REQUIRE(ParseStat(Stat, Parsed));
+		CHECK(Parsed.name == Name);
+		CHECK(Parsed.parentPid == 17);
+		CHECK(Parsed.startTime == 987654);
+		CHECK(Parsed.residentPages == 321);
+	}
+}
+
+TEST_CASE(ProcStatRejectsMalformedLines) {
+	ProcStat Parsed;
+	CHECK(!ParseStat("", Parsed));
+	CHECK(!ParseStat("4242 bash S 17", Parsed));
+	CHECK(!ParseStat("4242 )bash( S 17", Parsed));
+	CHECK(!ParseStat("4242 (bash) S 17 4242 33", Parsed)); // Truncated before the start time
+}
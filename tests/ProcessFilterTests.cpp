@@ -0,0 +1,62 @@
+#include "CoreTest.h"
+#include "ProcessTable.h"
+#include <string>
+
+// Rows whose lowercased label contains the lowercased query, by a plain scan
+static std::vector<uint32_t> ScanRows(const ProcessColumns& Processes, std::string_view Query) {
+	std::string LowercaseQuery, LowercaseLabel;
+	ProcessSearchIndex::ToLower(Query, LowercaseQuery);
+	std::vector<uint32_t> Rows;
+	for (uint32_t Row = 0; Row < Processes.Size(); ++Row) {
+		ProcessSearchIndex::ToLower(Processes.LabelView(Row), LowercaseLabel);
+		if (LowercaseLabel.find(LowercaseQuery) != std::string::npos) {
+			Rows.push_back(Row);
+		}
+	}
+	return Rows;
+}
+
+static std::shared_ptr<ProcessSnapshot> MakeSyntheticSnapshot(size_t ProcessCount) {
+	auto Source = CreateSyntheticProcessSource(ProcessCount, 3);
+	ProcessTable Table;
+	Table.RefreshProcessIDList(*Source);
+	return Table.MakeSnapshot(1);
+}
+
+TEST_CASE(ProcessSearchIndexMatchesFullScan) {
+	const auto Snapshot = MakeSyntheticSnapshot(3000);
+	const char* const Queries[] = { "", "s", "SV", "svc", "Host.EXE", "worker_1", "(12)", " (", "e (4", "zzz", "exe)" };
+	for (const char* Query : Queries) {
+		std::string LowercaseQuery;
+		ProcessSearchIndex::ToLower(Query, LowercaseQuery);
+		std::vector<uint32_t> Rows;
+		Snapshot->SearchIndex.Search(LowercaseQuery, Rows);
+		CHECK(Rows == ScanRows(Snapshot->Processes, Query));
+	}
+}
+
+TEST_CASE(ProcessFilterNarrowingMatchesFullScan) {
+	const auto Snapshot = MakeSyntheticSnapshot(3000);
+	// Typing, backspacing, retyping with different case, and edits that do not extend the previous query
+	const char* const Edits[] = {
+		"s", "sv", "svc", "svch", "svcho", "svchost", "svcho", "sv", "", "w", "wo", "WOR", "Worker_", "worker_12",
+		"orker_12", "(4", "(40", "(400", "(4000)", "x", "", "exe", "exe (", "chrome.exe (1",
+	};
+	ProcessFilter Filter;
+	for (const char* Query : Edits) {
+		Filter.Update(Snapshot->SearchIndex, 1, Query);
+		CHECK(Filter.MatchingRows() == ScanRows(Snapshot->Processes, Query));
+	}
+}
+
+TEST_CASE(ProcessFilterRescansWhenTheIndexChanges) {
+	const auto First = MakeSyntheticSnapshot(500);
+	const auto Second = MakeSyntheticSnapshot(2000);
+	ProcessFilter Filter;
+	Filter.Update(First->SearchIndex, 1, "svc");
+	CHECK(Filter.MatchingRows() == ScanRows(First->Processes, "svc"));
+	// A longer query on a newer index must not narrow the old result
+	Filter.Update(Second->SearchIndex, 2, "svch");
+	CHECK(Filter.MatchingRows() == ScanRows(Second->Processes, "svch"));
+	CHECK(!Filter.Update(Second->SearchIndex, 2, "svch"));
+}
@@ -0,0 +1,78 @@
+#include "CoreTest.h"
+#include "ProcessMetadataCache.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace {
+
+// Records every queried PID; the first query is held until the test releases it
+struct GatedMetadataSource : ProcessSource {
+	mutable std::mutex Mutex;
+	mutable std::condition_variable Changed;
+	mutable DynamicArray<std::uint32_t> Queried;
+	bool Released = false;
+
+	bool Enumerate(const std::function<void(const ProcessSourceEntry&)>&) override { return true; }
+
+	bool QueryMetadata(const ProcessKey& Key, ProcessMetadata&) const override {
+		std::unique_lock Lock(Mutex);
+		Queried.push_back(Key.pid);
+		Changed.notify_all();
+		Changed.wait(Lock, [&] { return Released; });
+		return true;
+	}
+
+	void WaitForQueries(size_t Count) const {
+		std::unique_lock Lock(Mutex);
+		Changed.wait_for(Lock, std::chrono::seconds(5), [&] { return Queried.size() >= Count; });
+	}
+	void Release() {
+		std::lock_guard Lock(Mutex);
+		Released = true;
+		Changed.notify_all();
+	}
+};
+
+} // namespace
+
+TEST_CASE(ProcessMetadataCacheDropsRowsScrolledAway) {
+	auto Owned = std::make_unique<GatedMetadataSource>();
+	GatedMetadataSource& Source = *Owned;
+	std::mutex ResultMutex;
+	std::condition_variable ResultArrived;
+	ProcessMetadataCache Cache(std::move(Owned), [&] {
+		std::lock_guard Lock(ResultMutex);
+		ResultArrived.notify_all();
+	}, 1);
+	const auto WaitFor = [&](const ProcessKey& Key) {
+		std::unique_lock Lock(ResultMutex);
+		return ResultArrived.wait_for(Lock, std::chrono::seconds(5), [&] { return Cache.Get(Key) != nullptr; });
+	};
+
+	// The single worker blocks on the selected process while one frame shows a thousand rows
+	Cache.BeginFrame();
+	CHECK(Cache.Get({ 5000, 1 }) == nullptr);
+	Source.WaitForQueries(1);
+	for (std::uint32_t Pid = 1; Pid <= 1000; ++Pid) {
+		CHECK(Cache.Get({ Pid, 1 }) == nullptr);
+	}
+
+	// The list is scrolled: two frames later only row 10 is still on screen
+	Cache.BeginFrame();
+	Cache.BeginFrame();
+	CHECK(Cache.Get({ 10, 1 }) == nullptr);
+	Source.Release();
+	REQUIRE(WaitFor({ 10, 1 }));
+	{
+		std::lock_guard Lock(Source.Mutex);
+		CHECK(Source.Queried == DynamicArray<std::uint32_t>({ 5000, 10 }));
+	}
+
+	// A dropped row that comes back is queued again
+	CHECK(Cache.Get({ 500, 1 }) == nullptr);
+	REQUIRE(WaitFor({ 500, 1 }));
+	std::lock_guard Lock(Source.Mutex);
+	CHECK(Source.Queried.size() == 3);
+	CHECK(Source.Queried.back() == 500);
+}
@@ -0,0 +1,91 @@
+#include "CoreTest.h"
+#include "ProcessModuleCache.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+namespace {
+
+// Module lists the test edits, with each enumeration held until the test releases it
+struct GatedModuleSource : ProcessSource {
+	mutable std::mutex Mutex;
+	mutable std::condition_variable Changed;
+	DynamicArray<std::string> ModulePaths;
+	mutable int Started = 0;
+	int Released = 0;
+
+	bool Enumerate(const std::function<void(const ProcessSourceEntry&)>&) override { return true; }
+	bool QueryMetadata(const ProcessKey&, ProcessMetadata&) const override { return false; }
+
+	bool EnumerateModules(const ProcessKey&, const std::function<void(const ProcessModuleEntry&)>& Visit) const override {
+		std::unique_lock Lock(Mutex);
+		const DynamicArray<std::string> Paths = ModulePaths; // A snapshot, like a real module list
+		const int Pass = ++Started;
+		Changed.notify_all();
+		Changed.wait(Lock, [&] { return Released >= Pass; });
+		Lock.unlock();
+		std::uint64_t Base = 0x10000;
+		for (const std::string& Path : Paths) {
+			Visit({ Base, 0x1000, Path });
+			Base += 0x10000;
+		}
+		return true;
+	}
+
+	// Blocks until enumeration number Pass has started
+	void WaitForStart(int Pass) const {
+		std::unique_lock Lock(Mutex);
+		Changed.wait_for(Lock, std::chrono::seconds(5), [&] { return Started >= Pass; });
+	}
+	void Release() {
+		std::lock_guard Lock(Mutex);
+		++Released;
+		Changed.notify_all();
+	}
+};
+
+} // namespace
+
+TEST_CASE(ProcessModuleCacheRefreshDuringEnumerationIsKept) {
+	auto Owned = std::make_unique<GatedModuleSource>();
+	GatedModuleSource& Source = *Owned;
+	Source.ModulePaths = { "/usr/bin/target" };
+	std::mutex ResultMutex;
+	std::condition_variable ResultArrived;
+	int Results = 0;
+	ProcessModuleCache Cache(std::move(Owned), [&] {
+		std::lock_guard Lock(ResultMutex);
+		++Results;
+		ResultArrived.notify_all();
+	});
+	const auto WaitForResults = [&](int Count) {
+		std::unique_lock Lock(ResultMutex);
+		return ResultArrived.wait_for(Lock, std::chrono::seconds(5), [&] { return Results >= Count; });
+	};
+
+	const ProcessKey Key = { 1234, 1 };
+	CHECK(Cache.Get(Key) == nullptr);
+	Source.Release();
+	REQUIRE(WaitForResults(1));
+
+	// An injection lands while the refresh it triggers is still enumerating the old module list
+	Cache.Refresh(Key);
+	Source.WaitForStart(2);
+	Cache.Refresh(Key);
+	{
+		std::lock_guard Lock(Source.Mutex);
+		Source.ModulePaths.push_back("/tmp/injected.so");
+	}
+	CHECK(Cache.IsRefreshing(Key));
+	Source.Release();
+	Source.Release();
+	REQUIRE(WaitForResults(3));
+
+	const auto Modules = Cache.Get(Key);
+	REQUIRE(Modules != nullptr);
+	REQUIRE(Modules->modules.size() == 2);
+	CHECK(Modules->modules[1].path == "/tmp/injected.so");
+	CHECK(Modules->modules[1].added);
+	CHECK(!Cache.IsRefreshing(Key));
+}
@@ -0,0 +1,147 @@
+#include "CoreTest.h"
+#include "ProcessTable.h"
+#include <algorithm>
+#include <string>
+#include <tuple>
+
+namespace {
+
+struct ScriptedProcess {
+	ProcessKey key;
+	std::string name;
+};
+
+// Enumerates whatever the test put in Processes; also used to replay another source's output
+struct ScriptedProcessSource : ProcessSource {
+	DynamicArray<ScriptedProcess> Processes;
+
+	bool Enumerate(const std::function<void(const ProcessSourceEntry&)>& Visit) override {
+		for (const ScriptedProcess& Process : Processes) {
+			ProcessSourceEntry Entry;
+			Entry.pid = Process.key.pid;
+			Entry.creationTime = Process.key.creationTime;
+			Entry.utf8Name = Process.name;
+			Visit(Entry);
+		}
+		return true;
+	}
+
+	bool QueryMetadata(const ProcessKey&, ProcessMetadata&) const override { return false; }
+};
+
+// pid, creation time, label
+using TableRow = std::tuple<ProcessID, std::uint64_t, std::string>;
+
+// The table's rows as (key, label), sorted so the comparison ignores row order
+DynamicArray<TableRow> SortedRows(const ProcessColumns& Processes) {
+	DynamicArray<TableRow> Rows;
+	for (size_t Row = 0; Row < Processes.Size(); ++Row) {
+		Rows.emplace_back(Processes.Pids[Row], Processes.CreationTimes[Row], Processes.LabelView(Row));
+	}
+	std::sort(Rows.begin(), Rows.end());
+	return Rows;
+}
+
+// What a table built from scratch over the same processes would hold
+DynamicArray<TableRow> ExpectedRows(const DynamicArray<ScriptedProcess>& Processes) {
+	DynamicArray<TableRow> Rows;
+	for (const ScriptedProcess& Process : Processes) {
+		Rows.emplace_back(Process.key.pid, Process.key.creationTime, Process.name + " (" + std::to_string(Process.key.pid) + ")");
+	}
+	std::sort(Rows.begin(), Rows.end());
+	return Rows;
+}
+
+} // namespace
+
+TEST_CASE(ProcessTableFollowsSyntheticChurn) {
+	auto Synthetic = CreateSyntheticProcessSource(2000, 5, 0.05);
+	ScriptedProcessSource Replay;
+	ProcessTable Table;
+	for (int Refresh = 0; Refresh < 25; ++Refresh) {
+		// Capture one enumeration so the same process list feeds both the table and the expectation
+		Replay.Processes.clear();
+		Synthetic->Enumerate([&](const ProcessSourceEntry& Entry) {
+			Replay.Processes.push_back({ { Entry.pid, Entry.creationTime }, std::string(Entry.utf8Name) });
+		});
+		const bool Changed = Table.RefreshProcessIDList(Replay);
+		CHECK(Changed);
+		CHECK(SortedRows(Table.Processes()) == ExpectedRows(Replay.Processes));
+	}
+	CHECK(!Table.RefreshProcessIDList(Replay)); // Same list again
+}
+
+TEST_CASE(ProcessTableAddsAndRemoves) {
+	ScriptedProcessSource Source;
+	Source.Processes = { { { 4, 10 }, "System" }, { { 8, 20 }, "smss.exe" }, { { 12, 30 }, "csrss.exe" } };
+	ProcessTable Table;
+	CHECK(Table.RefreshProcessIDList(Source));
+	CHECK(SortedRows(Table.Processes()) == ExpectedRows(Source.Processes));
+
+	Source.Processes.erase(Source.Processes.begin() + 1);
+	Source.Processes.push_back({ { 16, 40 }, "wininit.exe" });
+	CHECK(Table.RefreshProcessIDList(Source));
+	CHECK(SortedRows(Table.Processes()) == ExpectedRows(Source.Processes));
+
+	Source.Processes.clear();
+	CHECK(Table.RefreshProcessIDList(Source));
+	CHECK(Table.Processes().Size() == 0);
+	CHECK(!Table.RefreshProcessIDList(Source));
+}
+
+TEST_CASE(ProcessTableReplacesRecycledPIDs) {
+	ScriptedProcessSource Source;
+	Source.Processes = { { { 4, 10 }, "System" }, { { 100, 50 }, "old.exe" } };
+	ProcessTable Table;
+	Table.RefreshProcessIDList(Source);
+
+	// Same PID, later creation time and a different name: a new instance, not the old row
+	Source.Processes[1] = { { 100, 90 }, "new.exe" };
+	CHECK(Table.RefreshProcessIDList(Source));
+	CHECK(SortedRows(Table.Processes()) == ExpectedRows(Source.Processes));
+	const auto Snapshot = Table.MakeSnapshot(1);
+	const int Row = Snapshot->FindRow(100);
+	REQUIRE(Row >= 0);
+	CHECK(Snapshot->Processes.CreationTimes[Row] == 90);
+	CHECK(Snapshot->Processes.LabelView(Row) == "new.exe (100)");
+}
+
+TEST_CASE(ProcessTableSnapshotLooksUpEveryRow) {
+	auto Source = CreateSyntheticProcessSource(5000, 9);
+	ProcessTable Table;
+	Table.RefreshProcessIDList(*Source);
+	const auto Snapshot = Table.MakeSnapshot(7);
+	CHECK(Snapshot->Version == 7);
+	REQUIRE(Snapshot->Processes.Size() == 5000);
+	for (size_t Row = 0; Row < Snapshot->Processes.Size(); ++Row) {
+		CHECK(Snapshot->FindRow(Snapshot->Processes.Pids[Row]) == static_cast<int>(Row));
+	}
+	CHECK(Snapshot->FindRow(3) == -1); // Synthetic PIDs are multiples of four
+	CHECK(Snapshot->SearchIndex.Size() == Snapshot->Processes.Size());
+}
+
+TEST_CASE(ProcessTableEventsMatchUnknownCreationTimes) {
+	ScriptedProcessSource Source;
+	Source.Processes = { { { 4, 10 }, "System" }, { { 200, 0 }, "protected.exe" }, { { 300, 70 }, "app.exe" } };
+	ProcessTable Table;
+	Table.RefreshProcessIDList(Source);
+
+	const auto Exited = [](ProcessID Pid, std::uint64_t CreationTime) {
+		ProcessEvent Event;
+		Event.type = ProcessEventType::Exited;
+		Event.process.pid = Pid;
+		Event.process.creationTime = CreationTime;
+		return Event;
+	};
+	Table.BeginEventBatch();
+	Table.ApplyEvent(Exited(300, 71)); // Another instance of PID 300: the row stays
+	CHECK(!Table.EndEventBatch());
+
+	// The row's creation time is unknown, so an exit that carries one still removes it
+	Table.BeginEventBatch();
+	Table.ApplyEvent(Exited(200, 12345));
+	Table.ApplyEvent(Exited(300, 0));
+	CHECK(Table.EndEventBatch());
+	Source.Processes.resize(1);
+	CHECK(SortedRows(Table.Processes()) == ExpectedRows(Source.Processes));
+}
@@ -0,0 +1,39 @@
+#include "CoreTest.h"
+#include "TextConversion.h"
+
+TEST_CASE(TextConversionRoundTripsEveryPlane) {
+	// ASCII, two-, three- and four-byte UTF-8, the last plane boundary and a code point just below the surrogates
+	const char* const Samples[] = {
+		"", "notepad.exe", "caf\xC3\xA9.exe", "\xE6\xB5\x8B\xE8\xAF\x95.dll", "\xF0\x9F\x98\x80 emoji",
+		"\xF4\x8F\xBF\xBF", "\xED\x9F\xBF",
+	};
+	for (const char* Sample : Samples) {
+		CHECK(Utf8FromWide(WideFromUtf8(Sample)) == Sample);
+	}
+	CHECK(WideFromUtf8("\xC3\xA9") == std::wstring(1, static_cast<wchar_t>(0xE9)));
+	CHECK(WideFromUtf8("\xF0\x9F\x98\x80").size() == (sizeof(wchar_t) == 2 ? 2u : 1u));
+}
+
+TEST_CASE(TextConversionReplacesInvalidUtf8) {
+	const std::wstring Replacement(1, static_cast<wchar_t>(0xFFFD));
+	CHECK(WideFromUtf8("\xC0\xAF") == Replacement + Replacement);   // Overlong '/'
+	CHECK(WideFromUtf8("\xED\xA0\x80") == Replacement);              // Encoded surrogate
+	CHECK(WideFromUtf8("\xE6\xB5") == Replacement);                  // Truncated at the end
+	CHECK(WideFromUtf8("a\x80z") == L"a" + Replacement + L"z");     // Stray continuation byte
+	CHECK(WideFromUtf8("\xE6" "ab") == Replacement + L"ab");        // Lead byte followed by ASCII keeps the ASCII
+}
+
+TEST_CASE(TextConversionReplacesUnpairedSurrogates) {
+	const std::wstring Lone(1, static_cast<wchar_t>(0xD800));
+	CHECK(Utf8FromWide(Lone) == "\xEF\xBF\xBD");
+	CHECK(Utf8FromWide(L"x" + Lone + L"y") == "x\xEF\xBF\xBDy");
+}
+
+TEST_CASE(TextConversionAppends) {
+	std::string Utf8 = "prefix ";
+	AppendUtf8FromWide(L"tail", Utf8);
+	CHECK(Utf8 == "prefix tail");
+	std::wstring Wide = L"prefix ";
+	AppendWideFromUtf8("tail", Wide);
+	CHECK(Wide == L"prefix tail");
+}